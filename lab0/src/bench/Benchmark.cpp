@@ -0,0 +1,293 @@
+// Замер пропускной способности конвейера lab0 на синтетическом корпусе.
+// Корпус генерируется с распределением слов по закону Ципфа, затем по
+// отдельности замеряются стадии чтения, разбора, подсчета, сортировки и
+// записи. Результат выводится в JSON, чтобы его можно было сравнивать
+// между запусками.
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../core/WordCounter.h"
+#include "../core/WordProcessor.h"
+#include "../core/WordScanner.h"
+#include "../io/CSVWriter.h"
+#include "../io/FileReader.h"
+
+namespace {
+
+struct BenchOptions {
+    double sizeMb = 64;         // Размер корпуса
+    size_t vocabulary = 100000; // Число различных слов
+    double zipfExponent = 1.0;  // Показатель распределения Ципфа
+    unsigned seed = 42;
+    WordCounter::Backend backend = WordCounter::Backend::Tree;
+    WordScanner::Encoding encoding = WordScanner::Encoding::Ascii;
+    std::string corpusFile = "lab0_bench_corpus.txt";
+    std::string outputFile = "lab0_bench_output.csv";
+    bool keepFiles = false;
+};
+
+struct StageResult {
+    std::string name;
+    double seconds;
+    size_t bytes;
+    size_t words;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --size-mb N        corpus size in megabytes (default 64)\n"
+              << "  --vocab N          number of distinct words (default 100000)\n"
+              << "  --zipf S           Zipf exponent of word frequencies (default 1.0)\n"
+              << "  --seed N           random seed (default 42)\n"
+              << "  --backend tree|hash|compact\n"
+              << "  --encoding ascii|utf8\n"
+              << "  --corpus FILE      where to write the generated corpus\n"
+              << "  --keep             keep the corpus and CSV after the run\n";
+}
+
+BenchOptions parseOptions(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--size-mb") {
+            options.sizeMb = std::stod(value());
+        } else if (arg == "--vocab") {
+            options.vocabulary = std::stoul(value());
+        } else if (arg == "--zipf") {
+            options.zipfExponent = std::stod(value());
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned>(std::stoul(value()));
+        } else if (arg == "--backend") {
+            std::string backend = value();
+            if (backend == "tree") {
+                options.backend = WordCounter::Backend::Tree;
+            } else if (backend == "hash") {
+                options.backend = WordCounter::Backend::Hash;
+            } else if (backend == "compact") {
+                options.backend = WordCounter::Backend::Compact;
+            } else {
+                throw std::invalid_argument("Unknown backend: " + backend);
+            }
+        } else if (arg == "--encoding") {
+            std::string encoding = value();
+            if (encoding != "ascii" && encoding != "utf8") {
+                throw std::invalid_argument("Unknown encoding: " + encoding);
+            }
+            options.encoding = encoding == "utf8" ? WordScanner::Encoding::Utf8 : WordScanner::Encoding::Ascii;
+        } else if (arg == "--corpus") {
+            options.corpusFile = value();
+        } else if (arg == "--keep") {
+            options.keepFiles = true;
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    if (options.sizeMb <= 0 || options.vocabulary == 0) {
+        throw std::invalid_argument("Corpus size and vocabulary must be positive");
+    }
+    return options;
+}
+
+// Слово с номером rank: буквы в записи номера по основанию 26 с примесью
+// заглавных букв и цифр, чтобы разбор делал реальную работу
+std::string makeWord(size_t rank) {
+    std::string word;
+    size_t value = rank;
+    do {
+        word += static_cast<char>('a' + value % 26);
+        value /= 26;
+    } while (value > 0);
+    if (rank % 7 == 0) {
+        word[0] = static_cast<char>(word[0] - 'a' + 'A');
+    }
+    if (rank % 11 == 0) {
+        word += std::to_string(rank % 100);
+    }
+    return word;
+}
+
+// Записать корпус заданного размера, вернуть число слов в нем
+size_t generateCorpus(const BenchOptions& options) {
+    std::vector<std::string> words;
+    words.reserve(options.vocabulary);
+    for (size_t rank = 0; rank < options.vocabulary; ++rank) {
+        words.push_back(makeWord(rank));
+    }
+
+    // Вероятность слова с рангом k пропорциональна 1 / k^s
+    std::vector<double> weights(options.vocabulary);
+    for (size_t rank = 0; rank < options.vocabulary; ++rank) {
+        weights[rank] = 1.0 / std::pow(static_cast<double>(rank + 1), options.zipfExponent);
+    }
+    std::discrete_distribution<size_t> pickWord(weights.begin(), weights.end());
+    std::mt19937_64 rng(options.seed);
+
+    const char* separators[] = {" ", " ", " ", ", ", ". ", "; ", " - "};
+    std::uniform_int_distribution<size_t> pickSeparator(0, std::size(separators) - 1);
+    std::uniform_int_distribution<int> pickLineLength(4, 16);
+
+    std::ofstream out(options.corpusFile, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + options.corpusFile);
+    }
+
+    const size_t targetBytes = static_cast<size_t>(options.sizeMb * 1024 * 1024);
+    size_t written = 0;
+    size_t wordCount = 0;
+    std::string line;
+    while (written < targetBytes) {
+        line.clear();
+        int lineLength = pickLineLength(rng);
+        for (int i = 0; i < lineLength; ++i) {
+            line += words[pickWord(rng)];
+            line += i + 1 < lineLength ? separators[pickSeparator(rng)] : "\n";
+        }
+        out << line;
+        written += line.size();
+        wordCount += lineLength;
+    }
+    return wordCount;
+}
+
+template <class Function>
+double measure(Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+const char* backendName(WordCounter::Backend backend) {
+    switch (backend) {
+        case WordCounter::Backend::Hash:
+            return "hash";
+        case WordCounter::Backend::Compact:
+            return "compact";
+        default:
+            return "tree";
+    }
+}
+
+void printJson(const BenchOptions& options, size_t distinctWords, const std::vector<StageResult>& stages) {
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"size_mb\": " << options.sizeMb << ",\n"
+        << "  \"vocabulary\": " << options.vocabulary << ",\n"
+        << "  \"zipf\": " << options.zipfExponent << ",\n"
+        << "  \"seed\": " << options.seed << ",\n"
+        << "  \"backend\": \"" << backendName(options.backend) << "\",\n"
+        << "  \"encoding\": \"" << (options.encoding == WordScanner::Encoding::Utf8 ? "utf8" : "ascii") << "\",\n"
+        << "  \"distinct_words\": " << distinctWords << ",\n"
+        << "  \"stages\": [\n";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const StageResult& stage = stages[i];
+        double seconds = stage.seconds > 0 ? stage.seconds : 1e-9;
+        out << "    {\"stage\": \"" << stage.name << "\""
+            << ", \"seconds\": " << stage.seconds
+            << ", \"bytes\": " << stage.bytes
+            << ", \"words\": " << stage.words
+            << ", \"mb_per_s\": " << stage.bytes / seconds / (1024 * 1024)
+            << ", \"words_per_s\": " << stage.words / seconds
+            << "}" << (i + 1 < stages.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    std::cout << out.str();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        generateCorpus(options);
+        std::vector<StageResult> stages;
+
+        // Чтение: построчно, как в основном режиме lab0
+        std::vector<std::string> lines;
+        double seconds = measure([&]() {
+            lines = FileReader(options.corpusFile).readLines();
+        });
+        size_t bytes = 0;
+        for (const auto& line : lines) {
+            bytes += line.size() + 1;
+        }
+        stages.push_back({"read", seconds, bytes, 0});
+
+        // Разбор: слова складываются подряд в один буфер, без подсчета
+        std::string tokens;
+        std::vector<uint32_t> lengths;
+        tokens.reserve(bytes);
+        seconds = measure([&]() {
+            for (const auto& line : lines) {
+                WordScanner::scan(line.data(), line.size(), [&](std::string_view word) {
+                    tokens.append(word);
+                    lengths.push_back(static_cast<uint32_t>(word.size()));
+                }, options.encoding);
+            }
+        });
+        size_t words = lengths.size();
+        stages.push_back({"tokenize", seconds, bytes, words});
+
+        // Подсчет: готовые слова добавляются в счетчик
+        WordCounter counter(options.backend);
+        seconds = measure([&]() {
+            size_t offset = 0;
+            for (uint32_t length : lengths) {
+                counter.addWord(std::string_view(tokens.data() + offset, length));
+                offset += length;
+            }
+        });
+        stages.push_back({"count", seconds, tokens.size(), words});
+
+        // Сортировка по частоте
+        std::vector<WordCounter::Entry> sorted;
+        seconds = measure([&]() {
+            sorted = counter.getSortedWords();
+        });
+        stages.push_back({"sort", seconds, 0, sorted.size()});
+
+        // Запись CSV
+        uint64_t totalWords = counter.getTotalWords();
+        seconds = measure([&]() {
+            CSVWriter(options.outputFile).writeWordFrequency(sorted, totalWords);
+        });
+        std::ifstream written(options.outputFile, std::ios::binary | std::ios::ate);
+        stages.push_back({"write", seconds, static_cast<size_t>(written.tellg()), sorted.size()});
+        written.close();
+
+        printJson(options, counter.getDistinctWords(), stages);
+
+        if (!options.keepFiles) {
+            std::remove(options.corpusFile.c_str());
+            std::remove(options.outputFile.c_str());
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
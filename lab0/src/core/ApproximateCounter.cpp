@@ -0,0 +1,46 @@
+#include "ApproximateCounter.h"
+#include <algorithm>
+#include <cmath>
+#include "FlatWordTable.h"
+#include "WordCounter.h"
+
+ApproximateCounter::ApproximateCounter(size_t memoryBytes)
+    : sketch(CountMinSketch::withMemory(memoryBytes / 2)),
+      heavyHitters(SpaceSaving::capacityForMemory(memoryBytes / 2)),
+      totalWords(0) {}
+
+void ApproximateCounter::addWord(std::string_view word) {
+    if (word.empty()) {
+        return;
+    }
+    uint64_t hash = FlatWordTable::hashWord(word);
+    sketch.add(hash);
+    heavyHitters.add(word, hash);
+    totalWords++;
+}
+
+std::vector<ApproximateCounter::Entry> ApproximateCounter::getTopK(size_t k) const {
+    std::vector<Entry> result;
+    for (const SpaceSaving::Item& item : heavyHitters.top(heavyHitters.size())) {
+        uint64_t estimate = std::min(item.count, sketch.estimate(FlatWordTable::hashWord(item.word)));
+        uint64_t lowerBound = item.count - item.error;
+        result.push_back(Entry{item.word, estimate, std::min(lowerBound, estimate)});
+    }
+
+    // Уточненная оценка может поменять порядок, поэтому сортируем заново
+    auto comesBefore = [](const Entry& a, const Entry& b) {
+        return WordCounter::comesBefore({a.word, a.estimate}, {b.word, b.estimate});
+    };
+    k = std::min(k, result.size());
+    std::partial_sort(result.begin(), result.begin() + k, result.end(), comesBefore);
+    result.resize(k);
+    return result;
+}
+
+uint64_t ApproximateCounter::getErrorBound() const {
+    return static_cast<uint64_t>(std::ceil(sketch.epsilon() * static_cast<double>(totalWords)));
+}
+
+size_t ApproximateCounter::getMemoryUsage() const {
+    return sketch.memoryUsage() + heavyHitters.memoryUsage();
+}
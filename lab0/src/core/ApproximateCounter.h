@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "CountMinSketch.h"
+#include "SpaceSaving.h"
+
+// Приближенный подсчет в фиксированной памяти для входов, на которые не
+// хватает точной таблицы WordCounter. Половина бюджета отдается Count-Min
+// Sketch, половина - Space-Saving, который хранит кандидатов в самые частые
+// слова. Оценка частоты - меньшая из двух верхних оценок, нижняя граница
+// берется из Space-Saving. Слова длиннее SpaceSaving::MAX_WORD_BYTES байт
+// учитываются в общем числе слов, но в список самых частых не попадают.
+class ApproximateCounter {
+public:
+    struct Entry {
+        std::string_view word;
+        uint64_t estimate;      // Верхняя оценка частоты
+        uint64_t lowerBound;    // Частота гарантированно не меньше
+    };
+
+private:
+    CountMinSketch sketch;
+    SpaceSaving heavyHitters;
+    uint64_t totalWords;
+
+public:
+    // memoryBytes - общий бюджет памяти на обе структуры
+    explicit ApproximateCounter(size_t memoryBytes);
+
+    // Учесть одно вхождение слова (пустые слова пропускаются)
+    void addWord(std::string_view word);
+
+    // k самых частых слов по убыванию оценки (при равенстве - по алфавиту)
+    std::vector<Entry> getTopK(size_t k) const;
+
+    // Точное число учтенных слов
+    uint64_t getTotalWords() const { return totalWords; }
+
+    // Сколько слов сейчас хранится в Space-Saving
+    size_t getTrackedWords() const { return heavyHitters.size(); }
+
+    // Наибольшее превышение оценки над истинной частотой, которое
+    // Count-Min Sketch допускает с вероятностью не меньше 1 - getDelta()
+    uint64_t getErrorBound() const;
+
+    double getEpsilon() const { return sketch.epsilon(); }
+    double getDelta() const { return sketch.delta(); }
+
+    size_t getMemoryUsage() const;
+};
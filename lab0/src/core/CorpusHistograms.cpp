@@ -0,0 +1,94 @@
+#include "CorpusHistograms.h"
+#include <algorithm>
+#include <cstring>
+
+CorpusHistograms::CorpusHistograms()
+    : byteCounts{}, wordLengths(MAX_WORD_LENGTH + 1, 0), lineLengths(MAX_LINE_LENGTH + 1, 0), currentLine(0) {}
+
+void CorpusHistograms::addBytes(const char* data, size_t size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    // Четыре подгистограммы: каждый байт из четверки увеличивает свой счетчик
+    size_t i = 0;
+    for (; i + LANES <= size; i += LANES) {
+        byteCounts[0][bytes[i]]++;
+        byteCounts[1][bytes[i + 1]]++;
+        byteCounts[2][bytes[i + 2]]++;
+        byteCounts[3][bytes[i + 3]]++;
+    }
+    for (; i < size; ++i) {
+        byteCounts[0][bytes[i]]++;
+    }
+
+    // Концы строк ищем через memchr, который сам работает словами
+    const char* pos = data;
+    const char* end = data + size;
+    while (pos < end) {
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (newline == nullptr) {
+            currentLine += end - pos;
+            break;
+        }
+        currentLine += newline - pos;
+        lineLengths[std::min<uint64_t>(currentLine, MAX_LINE_LENGTH)]++;
+        currentLine = 0;
+        pos = newline + 1;
+    }
+}
+
+void CorpusHistograms::addWord(std::string_view word) {
+    size_t length = 0;
+    for (unsigned char c : word) {
+        length += (c & 0xC0) != 0x80;
+    }
+    wordLengths[std::min(length, MAX_WORD_LENGTH)]++;
+}
+
+void CorpusHistograms::finish() {
+    if (currentLine > 0) {
+        lineLengths[std::min<uint64_t>(currentLine, MAX_LINE_LENGTH)]++;
+        currentLine = 0;
+    }
+}
+
+uint64_t CorpusHistograms::getByteCount(unsigned char byte) const {
+    uint64_t total = 0;
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        total += byteCounts[lane][byte];
+    }
+    return total;
+}
+
+std::vector<CorpusHistograms::Row> CorpusHistograms::lengthRows(const std::vector<uint64_t>& counts) {
+    std::vector<Row> rows;
+    for (size_t length = 0; length < counts.size(); ++length) {
+        if (counts[length] == 0) {
+            continue;
+        }
+        std::string label = std::to_string(length);
+        if (length + 1 == counts.size()) {
+            label += "+";
+        }
+        rows.emplace_back(label, counts[length]);
+    }
+    return rows;
+}
+
+std::vector<CorpusHistograms::Row> CorpusHistograms::wordLengthRows() const {
+    return lengthRows(wordLengths);
+}
+
+std::vector<CorpusHistograms::Row> CorpusHistograms::lineLengthRows() const {
+    return lengthRows(lineLengths);
+}
+
+std::vector<CorpusHistograms::Row> CorpusHistograms::byteRows() const {
+    std::vector<Row> rows;
+    for (unsigned b = 0; b < 256; ++b) {
+        uint64_t count = getByteCount(static_cast<unsigned char>(b));
+        if (count > 0) {
+            rows.emplace_back(std::to_string(b), count);
+        }
+    }
+    return rows;
+}
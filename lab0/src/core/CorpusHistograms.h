@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Статистика корпуса: длины слов (в символах), частоты байтов и длины
+// строк (в байтах, без перевода строки). Байты раскладываются по четырем
+// независимым подгистограммам, которые складываются при чтении результата:
+// соседние одинаковые байты не ждут друг друга на записи в один счетчик.
+class CorpusHistograms {
+public:
+    // Длины не меньше MAX_LENGTH попадают в последний интервал
+    static constexpr size_t MAX_WORD_LENGTH = 64;
+    static constexpr size_t MAX_LINE_LENGTH = 1024;
+
+    // Строка отчета: подпись интервала и количество
+    using Row = std::pair<std::string, uint64_t>;
+
+private:
+    static constexpr size_t LANES = 4;
+
+    uint64_t byteCounts[LANES][256];
+    std::vector<uint64_t> wordLengths;
+    std::vector<uint64_t> lineLengths;
+    // Длина строки, начатой в предыдущих блоках
+    uint64_t currentLine;
+
+    static std::vector<Row> lengthRows(const std::vector<uint64_t>& counts);
+
+public:
+    CorpusHistograms();
+
+    // Учесть байты очередного блока входа. Строки могут переходить из блока в блок
+    void addBytes(const char* data, size_t size);
+
+    // Учесть длину слова (байты продолжения UTF-8 не считаются символами)
+    void addWord(std::string_view word);
+
+    // Завершить вход: строка без перевода строки в конце тоже учитывается
+    void finish();
+
+    uint64_t getByteCount(unsigned char byte) const;
+    const std::vector<uint64_t>& getWordLengths() const { return wordLengths; }
+    const std::vector<uint64_t>& getLineLengths() const { return lineLengths; }
+
+    // Строки отчетов. В длинах последний интервал подписан "N+",
+    // байты подписаны десятичным кодом; пустые интервалы пропускаются
+    std::vector<Row> wordLengthRows() const;
+    std::vector<Row> lineLengthRows() const;
+    std::vector<Row> byteRows() const;
+};
@@ -0,0 +1,55 @@
+#include "CountMinSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+CountMinSketch CountMinSketch::withMemory(size_t bytes, size_t depth) {
+    if (depth == 0) {
+        throw std::invalid_argument("Sketch depth must be positive");
+    }
+    size_t width = 1;
+    while (width * 2 * depth * sizeof(uint64_t) <= bytes) {
+        width *= 2;
+    }
+    return CountMinSketch(width, depth);
+}
+
+CountMinSketch::CountMinSketch(size_t w, size_t d) : width(w), depth(d), counters(w * d, 0) {
+    if (width == 0 || (width & (width - 1)) != 0 || depth == 0) {
+        throw std::invalid_argument("Sketch width must be a power of two and depth positive");
+    }
+}
+
+size_t CountMinSketch::cell(uint64_t hash, size_t row) const {
+    // Двойное хеширование: h1 + row * h2 дает depth независимых на практике функций
+    uint64_t h1 = hash;
+    uint64_t h2 = (hash >> 32) | (hash << 32) | 1;
+    return row * width + ((h1 + row * h2) & (width - 1));
+}
+
+void CountMinSketch::add(uint64_t hash) {
+    uint64_t minimum = estimate(hash);
+    for (size_t row = 0; row < depth; ++row) {
+        uint64_t& counter = counters[cell(hash, row)];
+        if (counter == minimum) {
+            counter++;
+        }
+    }
+}
+
+uint64_t CountMinSketch::estimate(uint64_t hash) const {
+    uint64_t minimum = std::numeric_limits<uint64_t>::max();
+    for (size_t row = 0; row < depth; ++row) {
+        minimum = std::min(minimum, counters[cell(hash, row)]);
+    }
+    return minimum;
+}
+
+double CountMinSketch::epsilon() const {
+    return std::exp(1.0) / static_cast<double>(width);
+}
+
+double CountMinSketch::delta() const {
+    return std::exp(-static_cast<double>(depth));
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Count-Min Sketch: приближенные частоты в фиксированной памяти.
+// depth строк по width счетчиков; слово увеличивает по одному счетчику в
+// каждой строке, оценка - минимум по строкам. Оценка никогда не меньше
+// истинной частоты и превышает ее не больше чем на epsilon() * N
+// с вероятностью не меньше 1 - delta().
+class CountMinSketch {
+private:
+    size_t width;
+    size_t depth;
+    std::vector<uint64_t> counters;
+
+    // Номер счетчика слова в строке row
+    size_t cell(uint64_t hash, size_t row) const;
+
+public:
+    // Подобрать размеры под бюджет памяти в байтах (ширина - степень двойки)
+    static CountMinSketch withMemory(size_t bytes, size_t depth = 4);
+
+    CountMinSketch(size_t width, size_t depth);
+
+    // Учесть одно вхождение слова с данным хешем. Используется
+    // консервативное обновление: увеличиваются только минимальные счетчики
+    void add(uint64_t hash);
+
+    // Оценка частоты слова
+    uint64_t estimate(uint64_t hash) const;
+
+    // Относительная погрешность e / width
+    double epsilon() const;
+
+    // Вероятность превысить погрешность: e^-depth
+    double delta() const;
+
+    size_t memoryUsage() const { return counters.size() * sizeof(uint64_t); }
+};
@@ -0,0 +1,384 @@
+#include "FlatWordTable.h"
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+constexpr uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+// Формат снимка (порядок байтов - как у машины, проверяется по полю byteOrder):
+//   SnapshotHeader
+//   SnapshotSlot[capacity]  - ячейки таблицы в их порядке; length == 0 - пустая
+//   char[stringBytes]       - байты слов, offset ячейки отсчитывается от начала
+// Версия 1 хранила 32-битные частоты (SnapshotSlotV1); такие снимки читаются
+constexpr char SNAPSHOT_MAGIC[8] = {'W', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t SNAPSHOT_VERSION = 2;
+constexpr uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t capacity;
+    uint64_t used;
+    uint64_t stringBytes;
+};
+
+struct SnapshotSlot {
+    uint64_t hash;
+    uint64_t offset;
+    uint32_t length;
+    uint32_t reserved;
+    uint64_t count;
+};
+
+struct SnapshotSlotV1 {
+    uint64_t hash;
+    uint64_t offset;
+    uint32_t length;
+    int32_t count;
+};
+
+// Разобранный и проверенный снимок
+struct SnapshotView {
+    SnapshotHeader header;
+    size_t slotSize;
+    const char* slots;
+    const char* strings;
+};
+
+SnapshotView parseSnapshot(const MappedFile& file) {
+    SnapshotView view{};
+    if (file.size() < sizeof(SnapshotHeader)) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    std::memcpy(&view.header, file.data(), sizeof(SnapshotHeader));
+
+    const SnapshotHeader& header = view.header;
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw std::runtime_error("Not a word count snapshot");
+    }
+    if ((header.version != SNAPSHOT_VERSION && header.version != 1) || header.byteOrder != SNAPSHOT_BYTE_ORDER) {
+        throw std::runtime_error("Unsupported snapshot version or byte order");
+    }
+    view.slotSize = header.version == 1 ? sizeof(SnapshotSlotV1) : sizeof(SnapshotSlot);
+    if (header.capacity == 0 || (header.capacity & (header.capacity - 1)) != 0 ||
+        header.used * 4 > header.capacity * 3 ||
+        header.capacity > (file.size() - sizeof(SnapshotHeader)) / view.slotSize ||
+        sizeof(SnapshotHeader) + header.capacity * view.slotSize + header.stringBytes != file.size()) {
+        throw std::runtime_error("Snapshot is corrupted");
+    }
+
+    view.slots = file.data() + sizeof(SnapshotHeader);
+    view.strings = view.slots + header.capacity * view.slotSize;
+    return view;
+}
+
+// Прочитать ячейку снимка с проверкой границ
+SnapshotSlot snapshotSlot(const SnapshotView& view, size_t index) {
+    SnapshotSlot slot{};
+    const char* record = view.slots + index * view.slotSize;
+    if (view.header.version == 1) {
+        SnapshotSlotV1 old;
+        std::memcpy(&old, record, sizeof(old));
+        if (old.count < 0) {
+            throw std::runtime_error("Snapshot is corrupted");
+        }
+        slot = SnapshotSlot{old.hash, old.offset, old.length, 0, static_cast<uint64_t>(old.count)};
+    } else {
+        std::memcpy(&slot, record, sizeof(slot));
+    }
+    if (slot.length > 0 &&
+        (slot.offset > view.header.stringBytes || slot.length > view.header.stringBytes - slot.offset)) {
+        throw std::runtime_error("Snapshot is corrupted");
+    }
+    return slot;
+}
+
+}
+
+FlatWordTable::FlatWordTable(bool compactCounts) : compact(compactCounts), used(0) {
+    if (compact) {
+        compactSlots.assign(INITIAL_CAPACITY, CompactSlot{0, nullptr, 0, 0});
+    } else {
+        wideSlots.assign(INITIAL_CAPACITY, WideSlot{0, nullptr, 0, 0});
+    }
+}
+
+template <class Visitor>
+decltype(auto) FlatWordTable::withSlots(Visitor&& visitor) {
+    return compact ? visitor(compactSlots) : visitor(wideSlots);
+}
+
+template <class Visitor>
+decltype(auto) FlatWordTable::withSlots(Visitor&& visitor) const {
+    return compact ? visitor(compactSlots) : visitor(wideSlots);
+}
+
+uint64_t FlatWordTable::countAt(const WideSlot& slot, size_t) const {
+    return slot.count;
+}
+
+uint64_t FlatWordTable::countAt(const CompactSlot& slot, size_t index) const {
+    uint64_t count = slot.count;
+    if (!highCounts.empty()) {
+        count |= static_cast<uint64_t>(highCounts[index]) << 32;
+    }
+    return count;
+}
+
+void FlatWordTable::setCount(WideSlot& slot, size_t, uint64_t count) {
+    slot.count = count;
+}
+
+void FlatWordTable::setCount(CompactSlot& slot, size_t index, uint64_t count) {
+    // Первая большая частота переводит таблицу на 64-битные частоты
+    if (count > UINT32_MAX && highCounts.empty()) {
+        highCounts.assign(compactSlots.size(), 0);
+    }
+    slot.count = static_cast<uint32_t>(count);
+    if (!highCounts.empty()) {
+        highCounts[index] = static_cast<uint32_t>(count >> 32);
+    }
+}
+
+uint64_t FlatWordTable::hashWord(std::string_view word) {
+    const char* p = word.data();
+    size_t n = word.size();
+    uint64_t h = n * HASH_MULTIPLIER;
+
+    // Слово обрабатывается по 8 байт за раз
+    while (n >= 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, p, 8);
+        h = (h ^ mix(chunk)) * HASH_MULTIPLIER;
+        p += 8;
+        n -= 8;
+    }
+
+    if (n > 0) {
+        uint64_t tail = 0;
+        std::memcpy(&tail, p, n);
+        h = (h ^ mix(tail)) * HASH_MULTIPLIER;
+    }
+
+    return mix(h);
+}
+
+template <class Slot>
+size_t FlatWordTable::findSlot(const std::vector<Slot>& slots, std::string_view word, uint64_t hash) {
+    size_t mask = slots.size() - 1;
+    size_t index = hash & mask;
+
+    while (true) {
+        const Slot& slot = slots[index];
+        if (slot.data == nullptr) {
+            return index;
+        }
+        if (slot.hash == hash && slot.length == word.size() &&
+            std::memcmp(slot.data, word.data(), word.size()) == 0) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+template <class Slot>
+void FlatWordTable::grow(std::vector<Slot>& slots) {
+    std::vector<Slot> old(slots.size() * 2, Slot{0, nullptr, 0, 0});
+    old.swap(slots);
+    // Старшие половины есть только у компактной таблицы
+    std::vector<uint32_t> oldHigh;
+    if (!highCounts.empty()) {
+        oldHigh.assign(slots.size(), 0);
+        oldHigh.swap(highCounts);
+    }
+
+    size_t mask = slots.size() - 1;
+    for (size_t i = 0; i < old.size(); ++i) {
+        const Slot& slot = old[i];
+        if (slot.data == nullptr) {
+            continue;
+        }
+        // Слова в таблице различны, поэтому достаточно найти свободную ячейку
+        size_t index = slot.hash & mask;
+        while (slots[index].data != nullptr) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = slot;
+        if (!oldHigh.empty()) {
+            highCounts[index] = oldHigh[i];
+        }
+    }
+}
+
+template <class Slot>
+void FlatWordTable::addTo(std::vector<Slot>& slots, std::string_view word, uint64_t count) {
+    uint64_t hash = hashWord(word);
+    size_t index = findSlot(slots, word, hash);
+    Slot& slot = slots[index];
+
+    if (slot.data != nullptr) {
+        if constexpr (std::is_same_v<Slot, WideSlot>) {
+            slot.count += count;
+        } else if (highCounts.empty() && count <= UINT32_MAX - slot.count) {
+            // Обычный случай: младшая половина не переполняется
+            slot.count += static_cast<uint32_t>(count);
+        } else {
+            setCount(slot, index, countAt(slot, index) + count);
+        }
+        return;
+    }
+
+    insert(slots, index, word, hash, count);
+}
+
+template <class Slot>
+size_t FlatWordTable::insert(std::vector<Slot>& slots, size_t index, std::string_view word, uint64_t hash, uint64_t count) {
+    // Заполненность держим не выше 3/4, иначе пробирование сильно удлиняется
+    if ((used + 1) * 4 > slots.size() * 3) {
+        grow(slots);
+        index = findSlot(slots, word, hash);
+    }
+
+    std::string_view stored = arena.store(word);
+    slots[index] = Slot{hash, stored.data(), static_cast<uint32_t>(stored.size()), 0};
+    setCount(slots[index], index, count);
+    used++;
+    return index;
+}
+
+void FlatWordTable::add(std::string_view word, uint64_t count) {
+    if (word.size() > UINT32_MAX) {
+        throw std::length_error("Word is too long");
+    }
+    withSlots([&](auto& slots) { addTo(slots, word, count); });
+}
+
+std::pair<std::string_view, uint64_t> FlatWordTable::tryAdd(std::string_view word, uint64_t count) {
+    if (word.size() > UINT32_MAX) {
+        throw std::length_error("Word is too long");
+    }
+    return withSlots([&](auto& slots) -> std::pair<std::string_view, uint64_t> {
+        uint64_t hash = hashWord(word);
+        size_t index = findSlot(slots, word, hash);
+        if (slots[index].data == nullptr) {
+            index = insert(slots, index, word, hash, count);
+        }
+        return {std::string_view(slots[index].data, slots[index].length), countAt(slots[index], index)};
+    });
+}
+
+uint64_t FlatWordTable::find(std::string_view word) const {
+    return withSlots([&](const auto& slots) -> uint64_t {
+        size_t index = findSlot(slots, word, hashWord(word));
+        return slots[index].data != nullptr ? countAt(slots[index], index) : 0;
+    });
+}
+
+size_t FlatWordTable::size() const {
+    return used;
+}
+
+size_t FlatWordTable::memoryUsage() const {
+    return wideSlots.capacity() * sizeof(WideSlot) + compactSlots.capacity() * sizeof(CompactSlot) +
+           highCounts.capacity() * sizeof(uint32_t) + arena.size();
+}
+
+void FlatWordTable::forEach(const std::function<void(std::string_view, uint64_t)>& visitor) const {
+    withSlots([&](const auto& slots) {
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (slots[i].data != nullptr) {
+                visitor(std::string_view(slots[i].data, slots[i].length), countAt(slots[i], i));
+            }
+        }
+    });
+}
+
+void FlatWordTable::saveSnapshot(std::ostream& out) const {
+    withSlots([&](const auto& slots) {
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        header.version = SNAPSHOT_VERSION;
+        header.byteOrder = SNAPSHOT_BYTE_ORDER;
+        header.capacity = slots.size();
+        header.used = used;
+        for (const auto& slot : slots) {
+            header.stringBytes += slot.length;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // Ячейки: указатели на слова заменяются смещениями в блоке строк
+        uint64_t offset = 0;
+        for (size_t i = 0; i < slots.size(); ++i) {
+            const auto& slot = slots[i];
+            SnapshotSlot record{slot.hash, 0, 0, 0, 0};
+            if (slot.data != nullptr) {
+                record = SnapshotSlot{slot.hash, offset, slot.length, 0, countAt(slot, i)};
+                offset += slot.length;
+            }
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+
+        for (const auto& slot : slots) {
+            if (slot.data != nullptr) {
+                out.write(slot.data, slot.length);
+            }
+        }
+    });
+}
+
+void FlatWordTable::loadSnapshot(MappedFile file) {
+    if (used != 0) {
+        throw std::logic_error("Snapshot can only be loaded into an empty table");
+    }
+
+    SnapshotView view = parseSnapshot(file);
+    std::vector<WideSlot> loaded(view.header.capacity, WideSlot{0, nullptr, 0, 0});
+    bool wide = false;
+    size_t loadedUsed = 0;
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        SnapshotSlot record = snapshotSlot(view, i);
+        if (record.length > 0) {
+            loaded[i] = WideSlot{record.hash, view.strings + record.offset, record.length, record.count};
+            wide = wide || record.count > UINT32_MAX;
+            loadedUsed++;
+        }
+    }
+    if (loadedUsed != view.header.used) {
+        throw std::runtime_error("Snapshot is corrupted");
+    }
+
+    if (compact) {
+        // Частоты делятся на половины; старшие заводятся, только если нужны
+        std::vector<CompactSlot> loadedCompact(loaded.size());
+        std::vector<uint32_t> loadedHigh(wide ? loaded.size() : 0);
+        for (size_t i = 0; i < loaded.size(); ++i) {
+            const WideSlot& slot = loaded[i];
+            loadedCompact[i] = CompactSlot{slot.hash, slot.data, slot.length, static_cast<uint32_t>(slot.count)};
+            if (wide) {
+                loadedHigh[i] = static_cast<uint32_t>(slot.count >> 32);
+            }
+        }
+        compactSlots.swap(loadedCompact);
+        highCounts.swap(loadedHigh);
+    } else {
+        wideSlots.swap(loaded);
+    }
+    used = loadedUsed;
+    snapshots.push_back(std::move(file));
+}
+
+void FlatWordTable::readSnapshot(
+    const MappedFile& file,
+    const std::function<void(std::string_view, uint64_t)>& visitor
+) {
+    SnapshotView view = parseSnapshot(file);
+    for (size_t i = 0; i < view.header.capacity; ++i) {
+        SnapshotSlot record = snapshotSlot(view, i);
+        if (record.length > 0) {
+            visitor(std::string_view(view.strings + record.offset, record.length), record.count);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "StringArena.h"
+#include "../io/MappedFile.h"
+#include "WordTable.h"
+
+// Хеш-таблица с открытой адресацией и линейным пробированием.
+// Все ячейки лежат в одном массиве, байты слов хранятся в арене,
+// а полный хеш слова запоминается, чтобы не пересчитывать его
+// при сравнении и перестроении таблицы.
+//
+// Обычная таблица хранит 64-битную частоту прямо в ячейке. Компактная
+// держит в ячейке младшие 32 бита, а старшие - в параллельном массиве
+// highCounts, который заводится только тогда, когда какая-нибудь частота
+// перестает помещаться в 32 бита.
+class FlatWordTable : public WordTable {
+private:
+    struct WideSlot {
+        uint64_t hash;
+        const char* data;   // nullptr - ячейка свободна
+        uint32_t length;
+        uint64_t count;
+    };
+
+    struct CompactSlot {
+        uint64_t hash;
+        const char* data;   // nullptr - ячейка свободна
+        uint32_t length;
+        uint32_t count;     // Младшие 32 бита частоты
+    };
+
+    static constexpr size_t INITIAL_CAPACITY = 1024;
+
+    bool compact;
+    // Используется один из массивов ячеек, в зависимости от compact
+    std::vector<WideSlot> wideSlots;
+    std::vector<CompactSlot> compactSlots;
+    // Старшие 32 бита частот компактной таблицы; пуст, пока все частоты малы
+    std::vector<uint32_t> highCounts;
+    size_t used;
+    StringArena arena;
+    // Загруженные снимки: слова из них читаются прямо из отображения
+    std::vector<MappedFile> snapshots;
+
+    // Вызвать visitor для используемого массива ячеек
+    template <class Visitor>
+    decltype(auto) withSlots(Visitor&& visitor);
+    template <class Visitor>
+    decltype(auto) withSlots(Visitor&& visitor) const;
+
+    // Найти ячейку со словом или свободную ячейку, куда его следует поместить
+    template <class Slot>
+    static size_t findSlot(const std::vector<Slot>& slots, std::string_view word, uint64_t hash);
+
+    // Увеличить массив ячеек вдвое и разложить слова заново
+    template <class Slot>
+    void grow(std::vector<Slot>& slots);
+
+    // Поместить новое слово в свободную ячейку index; вернуть ее индекс
+    // (после перестроения таблицы он может измениться)
+    template <class Slot>
+    size_t insert(std::vector<Slot>& slots, size_t index, std::string_view word, uint64_t hash, uint64_t count);
+
+    template <class Slot>
+    void addTo(std::vector<Slot>& slots, std::string_view word, uint64_t count);
+
+    uint64_t countAt(const WideSlot& slot, size_t index) const;
+    uint64_t countAt(const CompactSlot& slot, size_t index) const;
+    void setCount(WideSlot& slot, size_t index, uint64_t count);
+    void setCount(CompactSlot& slot, size_t index, uint64_t count);
+
+public:
+    // compact - хранить частоты в 32 битах, пока они помещаются
+    explicit FlatWordTable(bool compact = false);
+
+    void add(std::string_view word, uint64_t count) override;
+
+    // Если слова нет, добавить его с частотой count; имеющуюся частоту не
+    // менять. Возвращает копию слова в таблице (действительна, пока
+    // существует таблица) и его частоту
+    std::pair<std::string_view, uint64_t> tryAdd(std::string_view word, uint64_t count);
+    uint64_t find(std::string_view word) const override;
+    size_t size() const override;
+    size_t memoryUsage() const override;
+
+    // Хранятся ли частоты в 64 битах: всегда для обычной таблицы,
+    // для компактной - после первой частоты больше 32 бит
+    bool hasWideCounts() const { return !compact || !highCounts.empty(); }
+    void forEach(const std::function<void(std::string_view, uint64_t)>& visitor) const override;
+
+    // Записать снимок таблицы: заголовок, массив ячеек в том же порядке и
+    // байты слов. Формат описан в FlatWordTable.cpp
+    void saveSnapshot(std::ostream& out) const;
+
+    // Загрузить снимок в пустую таблицу. Ячейки копируются в том же порядке,
+    // без повторного хеширования, а слова остаются в отображенном файле
+    void loadSnapshot(MappedFile file);
+
+    // Проверить снимок и передать каждую его пару "слово - частота" в visitor
+    static void readSnapshot(
+        const MappedFile& file,
+        const std::function<void(std::string_view, uint64_t)>& visitor
+    );
+
+    // Хеш слова, используемый таблицей
+    static uint64_t hashWord(std::string_view word);
+
+    // Финальное перемешивание битов (из MurmurHash3); общее для всех
+    // хешей проекта
+    static uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+};
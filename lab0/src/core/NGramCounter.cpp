@@ -0,0 +1,148 @@
+#include "NGramCounter.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "FlatWordTable.h"
+
+NGramCounter::NGramCounter(size_t count)
+    : n(count), wordIds(true), window{}, seen(0), slots(INITIAL_CAPACITY, Slot{Key{0, 0}, 0}), used(0), total(0) {
+    if (n < MIN_N || n > MAX_N) {
+        throw std::invalid_argument("N-gram size must be between 2 and 4");
+    }
+}
+
+uint32_t NGramCounter::intern(std::string_view word) {
+    if (words.size() == std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Too many distinct words for n-gram counting");
+    }
+    uint64_t next = words.size() + 1;
+    auto [stored, value] = wordIds.tryAdd(word, next);
+    if (value == next) {
+        words.push_back(stored);
+    }
+    return static_cast<uint32_t>(value - 1);
+}
+
+NGramCounter::Key NGramCounter::currentKey() const {
+    // Номера укладываются по 32 бита, начиная со старших битов high
+    uint32_t ids[MAX_N] = {};
+    for (size_t i = 0; i < n; ++i) {
+        ids[i] = window[(seen + i) % n];
+    }
+    return Key{
+        (static_cast<uint64_t>(ids[0]) << 32) | ids[1],
+        (static_cast<uint64_t>(ids[2]) << 32) | ids[3]
+    };
+}
+
+uint64_t NGramCounter::hashKey(const Key& key) {
+    return FlatWordTable::mix(key.high * 0x9E3779B97F4A7C15ULL ^ key.low);
+}
+
+size_t NGramCounter::findSlot(const Key& key) const {
+    size_t mask = slots.size() - 1;
+    size_t pos = hashKey(key) & mask;
+    while (slots[pos].count != 0 && !(slots[pos].key == key)) {
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+void NGramCounter::grow() {
+    std::vector<Slot> old(slots.size() * 2, Slot{Key{0, 0}, 0});
+    old.swap(slots);
+    for (const Slot& slot : old) {
+        if (slot.count != 0) {
+            slots[findSlot(slot.key)] = slot;
+        }
+    }
+}
+
+void NGramCounter::addWord(std::string_view word) {
+    if (word.empty()) {
+        return;
+    }
+    window[seen % n] = intern(word);
+    seen++;
+    if (seen < n) {
+        return;
+    }
+
+    // Окно заполнено: самое старое слово лежит в ячейке seen % n
+    Key key = currentKey();
+    size_t pos = findSlot(key);
+    if (slots[pos].count == 0) {
+        if ((used + 1) * 4 > slots.size() * 3) {
+            grow();
+            pos = findSlot(key);
+        }
+        slots[pos].key = key;
+        used++;
+    }
+    slots[pos].count++;
+    total++;
+}
+
+void NGramCounter::reset() {
+    seen = 0;
+}
+
+uint64_t NGramCounter::getFrequency(std::string_view phrase) const {
+    uint32_t ids[MAX_N] = {};
+    size_t count = 0;
+    size_t start = 0;
+    while (start <= phrase.size()) {
+        size_t end = std::min(phrase.find(' ', start), phrase.size());
+        if (count == n) {
+            return 0;
+        }
+        uint64_t value = wordIds.find(phrase.substr(start, end - start));
+        if (value == 0) {
+            return 0;
+        }
+        ids[count++] = static_cast<uint32_t>(value - 1);
+        start = end + 1;
+    }
+    if (count != n) {
+        return 0;
+    }
+    Key key{(static_cast<uint64_t>(ids[0]) << 32) | ids[1], (static_cast<uint64_t>(ids[2]) << 32) | ids[3]};
+    return slots[findSlot(key)].count;
+}
+
+std::vector<WordCounter::Entry> NGramCounter::getSortedNGrams(size_t top) {
+    std::vector<WordCounter::Entry> result;
+    result.reserve(used);
+    std::string phrase;
+    for (const Slot& slot : slots) {
+        if (slot.count == 0) {
+            continue;
+        }
+        uint32_t ids[MAX_N] = {
+            static_cast<uint32_t>(slot.key.high >> 32), static_cast<uint32_t>(slot.key.high),
+            static_cast<uint32_t>(slot.key.low >> 32), static_cast<uint32_t>(slot.key.low)
+        };
+        phrase.clear();
+        for (size_t i = 0; i < n; ++i) {
+            if (i > 0) {
+                phrase += ' ';
+            }
+            phrase += words[ids[i]];
+        }
+        result.emplace_back(phrases.store(phrase), slot.count);
+    }
+
+    if (top > 0 && top < result.size()) {
+        std::partial_sort(result.begin(), result.begin() + top, result.end(), WordCounter::comesBefore);
+        result.resize(top);
+    } else {
+        std::sort(result.begin(), result.end(), WordCounter::comesBefore);
+    }
+    return result;
+}
+
+size_t NGramCounter::getMemoryUsage() const {
+    return slots.capacity() * sizeof(Slot) + wordIds.memoryUsage() +
+           words.capacity() * sizeof(std::string_view) + phrases.size();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "FlatWordTable.h"
+#include "StringArena.h"
+#include "WordCounter.h"
+
+// Счетчик n-грамм (последовательностей из n соседних слов, 2 <= n <= 4).
+// Каждое слово получает 32-битный номер (словарь - та же компактная
+// FlatWordTable, что и у счетчика слов), а n-грамма хранится как n номеров,
+// упакованных в 128-битный ключ, поэтому ее текст в таблице не повторяется.
+// Ключи лежат в хеш-таблице с открытой адресацией; текст n-грамм
+// собирается только при выводе.
+class NGramCounter {
+public:
+    static constexpr size_t MIN_N = 2;
+    static constexpr size_t MAX_N = 4;
+
+private:
+    struct Key {
+        uint64_t high;
+        uint64_t low;
+
+        bool operator==(const Key& other) const { return high == other.high && low == other.low; }
+    };
+
+    struct Slot {
+        Key key;
+        uint64_t count;  // 0 - ячейка свободна
+    };
+
+    static constexpr size_t INITIAL_CAPACITY = 1024;
+
+    size_t n;
+    // Словарь: слово -> номер + 1 (0 в таблице - слова нет) и номер -> слово.
+    // Слова хранятся в арене таблицы, words ссылается на них
+    FlatWordTable wordIds;
+    std::vector<std::string_view> words;
+    // Номера последних n слов (кольцевой буфер) и сколько слов уже прочитано
+    uint32_t window[MAX_N];
+    uint64_t seen;
+
+    std::vector<Slot> slots;
+    size_t used;
+    uint64_t total;
+    // Здесь лежит текст n-грамм, собранный для вывода
+    StringArena phrases;
+
+    uint32_t intern(std::string_view word);
+    Key currentKey() const;
+    static uint64_t hashKey(const Key& key);
+    size_t findSlot(const Key& key) const;
+    void grow();
+
+public:
+    explicit NGramCounter(size_t n);
+
+    // Учесть очередное слово входа; n-грамма засчитывается, как только
+    // набрано n слов подряд
+    void addWord(std::string_view word);
+
+    // Начать новую последовательность: следующая n-грамма не захватит
+    // слова, добавленные до вызова
+    void reset();
+
+    // Частота n-граммы; слова разделяются одним пробелом
+    uint64_t getFrequency(std::string_view phrase) const;
+
+    // n-граммы по убыванию частоты (при равенстве - по алфавиту), не больше
+    // top штук (0 - все). Текст n-грамм действителен, пока существует счетчик
+    std::vector<WordCounter::Entry> getSortedNGrams(size_t top = 0);
+
+    size_t getN() const { return n; }
+    uint64_t getTotalNGrams() const { return total; }
+    size_t getDistinctNGrams() const { return used; }
+    size_t getMemoryUsage() const;
+};
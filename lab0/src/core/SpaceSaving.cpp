@@ -0,0 +1,162 @@
+#include "SpaceSaving.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "WordCounter.h"
+
+namespace {
+
+size_t indexSizeFor(size_t capacity) {
+    size_t size = 1;
+    while (size < 2 * capacity) {
+        size *= 2;
+    }
+    return size;
+}
+
+}
+
+SpaceSaving::SpaceSaving(size_t cap) : capacity(cap) {
+    if (capacity == 0 || capacity >= std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Invalid Space-Saving capacity");
+    }
+    counters.reserve(capacity);
+    words.reserve(capacity * MAX_WORD_BYTES);
+    index.assign(indexSizeFor(capacity), 0);
+    heap.reserve(capacity);
+    heapPosition.reserve(capacity);
+}
+
+size_t SpaceSaving::capacityForMemory(size_t bytes) {
+    // Индекс занимает от 2 до 4 ячеек на слово; считаем по худшему случаю
+    constexpr size_t BYTES_PER_ITEM = sizeof(Counter) + MAX_WORD_BYTES + 6 * sizeof(uint32_t);
+    return std::max<size_t>(1, bytes / BYTES_PER_ITEM);
+}
+
+size_t SpaceSaving::memoryUsage() const {
+    return counters.capacity() * sizeof(Counter) + words.capacity() +
+           (index.capacity() + heap.capacity() + heapPosition.capacity()) * sizeof(uint32_t);
+}
+
+std::string_view SpaceSaving::wordAt(uint32_t id) const {
+    return std::string_view(words.data() + static_cast<size_t>(id) * MAX_WORD_BYTES, counters[id].length);
+}
+
+size_t SpaceSaving::findIndex(std::string_view word, uint64_t hash) const {
+    size_t mask = index.size() - 1;
+    size_t pos = hash & mask;
+    while (index[pos] != 0) {
+        uint32_t id = index[pos] - 1;
+        if (counters[id].hash == hash && wordAt(id) == word) {
+            break;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+void SpaceSaving::eraseIndex(size_t pos) {
+    // Удаление при линейном пробировании: записи за дырой, которые
+    // не стоят на своем месте, сдвигаются в нее
+    size_t mask = index.size() - 1;
+    size_t next = (pos + 1) & mask;
+    while (index[next] != 0) {
+        size_t home = counters[index[next] - 1].hash & mask;
+        if (((next - home) & mask) >= ((next - pos) & mask)) {
+            index[pos] = index[next];
+            pos = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index[pos] = 0;
+}
+
+void SpaceSaving::swapHeap(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    heapPosition[heap[a]] = static_cast<uint32_t>(a);
+    heapPosition[heap[b]] = static_cast<uint32_t>(b);
+}
+
+void SpaceSaving::siftUp(size_t pos) {
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (counters[heap[parent]].count <= counters[heap[pos]].count) {
+            break;
+        }
+        swapHeap(parent, pos);
+        pos = parent;
+    }
+}
+
+void SpaceSaving::siftDown(size_t pos) {
+    while (true) {
+        size_t smallest = pos;
+        size_t left = 2 * pos + 1;
+        size_t right = left + 1;
+        if (left < heap.size() && counters[heap[left]].count < counters[heap[smallest]].count) {
+            smallest = left;
+        }
+        if (right < heap.size() && counters[heap[right]].count < counters[heap[smallest]].count) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            return;
+        }
+        swapHeap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void SpaceSaving::add(std::string_view word, uint64_t hash) {
+    if (word.size() > MAX_WORD_BYTES) {
+        return;
+    }
+
+    size_t pos = findIndex(word, hash);
+    if (index[pos] != 0) {
+        uint32_t id = index[pos] - 1;
+        counters[id].count++;
+        siftDown(heapPosition[id]);
+        return;
+    }
+
+    uint32_t id;
+    if (counters.size() < capacity) {
+        id = static_cast<uint32_t>(counters.size());
+        counters.push_back(Counter{1, 0, hash, 0});
+        words.resize(words.size() + MAX_WORD_BYTES);
+        heap.push_back(id);
+        heapPosition.push_back(static_cast<uint32_t>(heap.size() - 1));
+        siftUp(heap.size() - 1);
+    } else {
+        // Вытесняем слово с наименьшим счетчиком; его ячейка слова переиспользуется
+        id = heap[0];
+        eraseIndex(findIndex(wordAt(id), counters[id].hash));
+        Counter& victim = counters[id];
+        victim.error = victim.count;
+        victim.count++;
+        victim.hash = hash;
+        siftDown(0);
+        pos = findIndex(word, hash);
+    }
+
+    std::copy(word.begin(), word.end(), words.begin() + static_cast<size_t>(id) * MAX_WORD_BYTES);
+    counters[id].length = static_cast<uint32_t>(word.size());
+    index[pos] = id + 1;
+}
+
+std::vector<SpaceSaving::Item> SpaceSaving::top(size_t k) const {
+    std::vector<Item> items;
+    items.reserve(counters.size());
+    for (uint32_t id = 0; id < counters.size(); ++id) {
+        items.push_back(Item{wordAt(id), counters[id].count, counters[id].error});
+    }
+
+    auto comesBefore = [](const Item& a, const Item& b) {
+        return WordCounter::comesBefore({a.word, a.count}, {b.word, b.count});
+    };
+    k = std::min(k, items.size());
+    std::partial_sort(items.begin(), items.begin() + k, items.end(), comesBefore);
+    items.resize(k);
+    return items;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Алгоритм Space-Saving для поиска самых частых слов в фиксированной памяти.
+// Хранится не больше capacity слов. Новое слово при заполненной таблице
+// вытесняет слово с наименьшим счетчиком и наследует его значение как
+// погрешность. Для каждого хранимого слова истинная частота лежит в
+// [count - error, count], а любое слово с частотой больше N / capacity
+// гарантированно присутствует в таблице.
+//
+// Вся память выделяется массивами фиксированного размера: байты слова лежат
+// в ячейке длиной MAX_WORD_BYTES, индекс - хеш-таблица с открытой адресацией
+// из номеров счетчиков. Слова длиннее MAX_WORD_BYTES не отслеживаются
+// (их частоту по-прежнему оценивает Count-Min Sketch), поэтому занятая
+// память не зависит от входа и не превышает бюджет.
+class SpaceSaving {
+public:
+    static constexpr size_t MAX_WORD_BYTES = 64;
+
+    struct Item {
+        std::string_view word;
+        uint64_t count;
+        uint64_t error;
+    };
+
+private:
+    struct Counter {
+        uint64_t count;
+        uint64_t error;
+        uint64_t hash;
+        uint32_t length;
+    };
+
+    size_t capacity;
+    std::vector<Counter> counters;
+    // Байты слов: слово счетчика id начинается с id * MAX_WORD_BYTES
+    std::vector<char> words;
+    // Номер счетчика + 1 (0 - ячейка свободна); размер - степень двойки,
+    // не меньше 2 * capacity
+    std::vector<uint32_t> index;
+    // Двоичная куча номеров счетчиков по возрастанию count и позиция каждого в куче
+    std::vector<uint32_t> heap;
+    std::vector<uint32_t> heapPosition;
+
+    std::string_view wordAt(uint32_t id) const;
+
+    // Ячейка индекса со словом или свободная ячейка, куда его следует поместить
+    size_t findIndex(std::string_view word, uint64_t hash) const;
+    // Освободить ячейку индекса, сдвинув назад следующие за ней записи
+    void eraseIndex(size_t pos);
+
+    void swapHeap(size_t a, size_t b);
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+
+public:
+    explicit SpaceSaving(size_t capacity);
+
+    // Сколько слов помещается в заданный бюджет памяти
+    static size_t capacityForMemory(size_t bytes);
+
+    // Учесть одно вхождение слова; hash - FlatWordTable::hashWord(word)
+    void add(std::string_view word, uint64_t hash);
+
+    // k слов с наибольшими счетчиками по убыванию (при равенстве - по алфавиту)
+    std::vector<Item> top(size_t k) const;
+
+    size_t size() const { return counters.size(); }
+    size_t getCapacity() const { return capacity; }
+
+    // Память, занятая массивами структуры
+    size_t memoryUsage() const;
+};
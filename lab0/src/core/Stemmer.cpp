@@ -0,0 +1,67 @@
+#include "Stemmer.h"
+
+namespace {
+
+// Русские окончания, от длинных к коротким (в UTF-8 каждая буква - два байта)
+constexpr std::string_view RUSSIAN_ENDINGS[] = {
+    "иями", "ями", "ами", "ого", "его", "ому", "ему", "ыми", "ими",
+    "ой", "ей", "ый", "ий", "ая", "яя", "ое", "ее", "ые", "ие", "ую", "юю",
+    "ом", "ем", "ам", "ям", "ах", "ях", "ов", "ев",
+    "а", "я", "ы", "и", "о", "е", "у", "ю", "ь", "й"
+};
+
+// Основа короче стольких символов не остается
+constexpr size_t MIN_STEM_LENGTH = 3;
+
+bool endsWith(std::string_view word, std::string_view suffix) {
+    return word.size() >= suffix.size() && word.compare(word.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Число символов UTF-8 (байты продолжения не считаются)
+size_t characterCount(std::string_view text) {
+    size_t count = 0;
+    for (unsigned char c : text) {
+        count += (c & 0xC0) != 0x80;
+    }
+    return count;
+}
+
+}
+
+std::string_view Stemmer::stem(std::string_view word) {
+    if (word.empty()) {
+        return word;
+    }
+    if (static_cast<unsigned char>(word[0]) < 0x80) {
+        return stemEnglish(word);
+    }
+    return stemRussian(word);
+}
+
+std::string_view Stemmer::stemEnglish(std::string_view word) {
+    // Множественное число: caresses -> caress, ponies -> poni, cats -> cat
+    if (endsWith(word, "sses") || endsWith(word, "ies")) {
+        word.remove_suffix(2);
+    } else if (endsWith(word, "s") && !endsWith(word, "ss") && !endsWith(word, "us") && word.size() > MIN_STEM_LENGTH) {
+        word.remove_suffix(1);
+    }
+
+    // Глагольные и наречные окончания: counting -> count, counted -> count
+    for (std::string_view suffix : {std::string_view("ing"), std::string_view("ed"), std::string_view("ly")}) {
+        if (endsWith(word, suffix) && word.size() >= suffix.size() + MIN_STEM_LENGTH) {
+            word.remove_suffix(suffix.size());
+            break;
+        }
+    }
+    return word;
+}
+
+std::string_view Stemmer::stemRussian(std::string_view word) {
+    for (std::string_view ending : RUSSIAN_ENDINGS) {
+        if (endsWith(word, ending) && characterCount(word) >= characterCount(ending) + MIN_STEM_LENGTH) {
+            word.remove_suffix(ending.size());
+            break;
+        }
+    }
+    return word;
+}
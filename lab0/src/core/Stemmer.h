@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string_view>
+
+// Легкий стеммер: отрезает частые окончания английских и русских слов.
+// Слово должно быть уже в нижнем регистре. Основа - это всегда начало
+// исходного слова, поэтому результат указывает в ту же память и ничего
+// не копирует. Правила намеренно простые: они сводят вместе формы слова,
+// но не претендуют на лингвистически точную основу.
+class Stemmer {
+public:
+    static std::string_view stem(std::string_view word);
+
+private:
+    static std::string_view stemEnglish(std::string_view word);
+    static std::string_view stemRussian(std::string_view word);
+};
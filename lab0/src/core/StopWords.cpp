@@ -0,0 +1,96 @@
+#include "StopWords.h"
+#include <algorithm>
+#include <stdexcept>
+#include "FlatWordTable.h"
+#include "../io/MappedFile.h"
+
+namespace {
+
+// Сколько зерен перебирается для одной корзины, прежде чем сдаться
+constexpr uint32_t MAX_SEED = 1u << 24;
+
+}
+
+StopWords::StopWords() : seeds(1, 0), slots(1, -1) {}
+
+StopWords::StopWords(std::vector<std::string> list) : StopWords() {
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+    list.erase(std::remove(list.begin(), list.end(), std::string()), list.end());
+    words = std::move(list);
+    if (words.empty()) {
+        return;
+    }
+
+    // Ячеек - степень двойки не меньше числа слов, корзин - вдвое меньше слов
+    size_t capacity = 1;
+    while (capacity < words.size()) {
+        capacity *= 2;
+    }
+    slots.assign(capacity, -1);
+    seeds.assign(std::max<size_t>(1, words.size() / 2), 0);
+
+    std::vector<uint64_t> hashes(words.size());
+    std::vector<std::vector<uint32_t>> buckets(seeds.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        hashes[i] = FlatWordTable::hashWord(words[i]);
+        buckets[bucketOf(hashes[i])].push_back(static_cast<uint32_t>(i));
+    }
+
+    // Большие корзины размещаем первыми, пока свободных ячеек много
+    std::vector<size_t> order(buckets.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&buckets](size_t a, size_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<size_t> taken;
+    for (size_t bucket : order) {
+        if (buckets[bucket].empty()) {
+            break;
+        }
+        bool placed = false;
+        for (uint32_t seed = 0; seed < MAX_SEED && !placed; ++seed) {
+            taken.clear();
+            placed = true;
+            for (uint32_t word : buckets[bucket]) {
+                size_t slot = slotOf(hashes[word], seed);
+                if (slots[slot] != -1 || std::find(taken.begin(), taken.end(), slot) != taken.end()) {
+                    placed = false;
+                    break;
+                }
+                taken.push_back(slot);
+            }
+            if (placed) {
+                seeds[bucket] = seed;
+                for (size_t i = 0; i < taken.size(); ++i) {
+                    slots[taken[i]] = static_cast<int32_t>(buckets[bucket][i]);
+                }
+            }
+        }
+        if (!placed) {
+            throw std::runtime_error("Cannot build perfect hash for stop words");
+        }
+    }
+}
+
+size_t StopWords::slotOf(uint64_t hash, uint32_t seed) const {
+    return FlatWordTable::mix(hash ^ (seed * 0x9E3779B97F4A7C15ULL)) & (slots.size() - 1);
+}
+
+StopWords StopWords::fromFile(const std::string& filename, WordScanner::Encoding encoding) {
+    MappedFile file(filename);
+    std::vector<std::string> list;
+    WordScanner::scan(file.data(), file.size(), [&list](std::string_view word) {
+        list.emplace_back(word);
+    }, encoding);
+    return StopWords(std::move(list));
+}
+
+bool StopWords::contains(std::string_view word) const {
+    uint64_t hash = FlatWordTable::hashWord(word);
+    int32_t index = slots[slotOf(hash, seeds[bucketOf(hash)])];
+    return index >= 0 && words[index] == word;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "WordScanner.h"
+
+// Множество стоп-слов с идеальным хешированием, построенным при загрузке.
+// Слова раскладываются по корзинам, и для каждой корзины подбирается
+// такое зерно хеша, чтобы все ее слова попали в свободные ячейки. Проверка
+// слова - один хеш, одно чтение зерна, одна ячейка и одно сравнение строк,
+// без цепочек и пробирования.
+class StopWords {
+private:
+    std::vector<std::string> words;
+    std::vector<uint32_t> seeds;    // Зерно каждой корзины
+    std::vector<int32_t> slots;     // Номер слова в ячейке, -1 - пусто
+
+    size_t bucketOf(uint64_t hash) const { return hash % seeds.size(); }
+    size_t slotOf(uint64_t hash, uint32_t seed) const;
+
+public:
+    // Пустое множество
+    StopWords();
+
+    // Построить хеш по словам (повторы отбрасываются). Слова должны быть
+    // нормализованы так же, как их выдает WordScanner
+    explicit StopWords(std::vector<std::string> words);
+
+    // Прочитать список из файла: стоп-словами считаются все слова файла,
+    // разобранные и приведенные к нижнему регистру как обычный вход
+    static StopWords fromFile(
+        const std::string& filename,
+        WordScanner::Encoding encoding = WordScanner::Encoding::Ascii
+    );
+
+    bool contains(std::string_view word) const;
+
+    size_t size() const { return words.size(); }
+};
@@ -0,0 +1,37 @@
+#include "StringArena.h"
+#include <cstdint>
+#include <cstring>
+
+StringArena::StringArena() : current(nullptr), remaining(0), bytesUsed(0) {}
+
+void* StringArena::allocate(size_t size, size_t alignment) {
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(current) % alignment) % alignment;
+
+    if (current == nullptr || size + padding > remaining) {
+        // Слишком большой запрос получает собственный блок, чтобы не
+        // выбрасывать остаток текущего
+        if (size > BLOCK_SIZE / 4) {
+            blocks.emplace_back(new char[size]);
+            bytesUsed += size;
+            return blocks.back().get();
+        }
+
+        // Память из new[] выровнена под любой базовый тип
+        blocks.emplace_back(new char[BLOCK_SIZE]);
+        current = blocks.back().get();
+        remaining = BLOCK_SIZE;
+        padding = 0;
+    }
+
+    char* result = current + padding;
+    current += padding + size;
+    remaining -= padding + size;
+    bytesUsed += size;
+    return result;
+}
+
+std::string_view StringArena::store(std::string_view str) {
+    char* dest = static_cast<char*>(allocate(str.size()));
+    std::memcpy(dest, str.data(), str.size());
+    return {dest, str.size()};
+}
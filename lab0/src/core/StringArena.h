@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Арена для байтов строк: память выделяется большими блоками и раздается
+// последовательно. Отдельные строки не освобождаются, вся память
+// освобождается вместе с ареной (по одному delete на блок).
+class StringArena {
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* current;
+    size_t remaining;
+    size_t bytesUsed;
+
+public:
+    StringArena();
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    // Выделить size байтов с выравниванием alignment (степень двойки)
+    void* allocate(size_t size, size_t alignment = 1);
+
+    // Скопировать строку в арену. Возвращенный view действителен,
+    // пока жива арена
+    std::string_view store(std::string_view str);
+
+    // Сколько байтов выдано из арены
+    size_t size() const { return bytesUsed; }
+
+    // Сколько блоков выделено
+    size_t blockCount() const { return blocks.size(); }
+};
+
+// Аллокатор для стандартных контейнеров, берущий память из арены.
+// deallocate ничего не делает: память возвращается вместе с ареной
+template <class T>
+class ArenaAllocator {
+private:
+    StringArena* arena;
+
+    template <class U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(StringArena& a) noexcept : arena(&a) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena != other.arena; }
+};
@@ -0,0 +1,36 @@
+#include "TreeWordTable.h"
+
+TreeWordTable::TreeWordTable() : wordFrequency(ArenaAllocator<Entry>(arena)) {}
+
+void TreeWordTable::add(std::string_view word, uint64_t count) {
+    // Байты слова копируются в арену только для нового слова
+    auto it = wordFrequency.lower_bound(word);
+    if (it != wordFrequency.end() && it->first == word) {
+        it->second += count;
+    } else {
+        wordFrequency.emplace_hint(it, arena.store(word), count);
+    }
+}
+
+uint64_t TreeWordTable::find(std::string_view word) const {
+    auto it = wordFrequency.find(word);
+    if (it != wordFrequency.end()) {
+        return it->second;
+    }
+    return 0;
+}
+
+size_t TreeWordTable::size() const {
+    return wordFrequency.size();
+}
+
+size_t TreeWordTable::memoryUsage() const {
+    // Узлы дерева и байты слов лежат в арене
+    return arena.size();
+}
+
+void TreeWordTable::forEach(const std::function<void(std::string_view, uint64_t)>& visitor) const {
+    for (const auto& pair : wordFrequency) {
+        visitor(pair.first, pair.second);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <map>
+#include <string_view>
+#include "StringArena.h"
+#include "WordTable.h"
+
+// Таблица на основе std::map: слова обходятся в алфавитном порядке.
+// Байты слов и узлы дерева берутся из одной арены, поэтому новое слово
+// не требует отдельных выделений памяти, а таблица освобождается целыми блоками
+class TreeWordTable : public WordTable {
+private:
+    using Entry = std::pair<const std::string_view, uint64_t>;
+
+    // Арена объявлена первой: она должна пережить дерево
+    StringArena arena;
+    std::map<std::string_view, uint64_t, std::less<>, ArenaAllocator<Entry>> wordFrequency;
+
+public:
+    TreeWordTable();
+
+    void add(std::string_view word, uint64_t count) override;
+    uint64_t find(std::string_view word) const override;
+    size_t size() const override;
+    size_t memoryUsage() const override;
+    void forEach(const std::function<void(std::string_view, uint64_t)>& visitor) const override;
+    bool isOrdered() const override { return true; }
+};
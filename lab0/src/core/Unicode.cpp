@@ -0,0 +1,342 @@
+#include "Unicode.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+namespace {
+
+enum class Folding : uint8_t {
+    None,       // Строчная форма совпадает с символом
+    Offset,     // Строчная форма = символ + delta
+    EvenUpper,  // Пары "прописная, строчная": прописная с четным кодом
+    OddUpper    // То же, но прописная с нечетным кодом
+};
+
+struct Range {
+    char32_t first;
+    char32_t last;
+    Unicode::CharClass charClass;
+    Folding folding;
+    int32_t delta;
+};
+
+constexpr Unicode::CharClass L = Unicode::CharClass::Letter;
+constexpr Unicode::CharClass D = Unicode::CharClass::Digit;
+constexpr Unicode::CharClass M = Unicode::CharClass::Mark;
+
+// Диапазоны упорядочены по first и не пересекаются
+const Range RANGES[] = {
+    {0x0030, 0x0039, D, Folding::None, 0},
+    {0x0041, 0x005A, L, Folding::Offset, 0x20},
+    {0x0061, 0x007A, L, Folding::None, 0},
+    {0x00AA, 0x00AA, L, Folding::None, 0},
+    {0x00B5, 0x00B5, L, Folding::None, 0},
+    {0x00BA, 0x00BA, L, Folding::None, 0},
+    {0x00C0, 0x00D6, L, Folding::Offset, 0x20},
+    {0x00D8, 0x00DE, L, Folding::Offset, 0x20},
+    {0x00DF, 0x00F6, L, Folding::None, 0},
+    {0x00F8, 0x00FF, L, Folding::None, 0},
+    // Latin Extended-A
+    {0x0100, 0x012F, L, Folding::EvenUpper, 0},
+    {0x0130, 0x0130, L, Folding::Offset, 0x0069 - 0x0130},
+    {0x0131, 0x0131, L, Folding::None, 0},
+    {0x0132, 0x0137, L, Folding::EvenUpper, 0},
+    {0x0138, 0x0138, L, Folding::None, 0},
+    {0x0139, 0x0148, L, Folding::OddUpper, 0},
+    {0x0149, 0x0149, L, Folding::None, 0},
+    {0x014A, 0x0177, L, Folding::EvenUpper, 0},
+    {0x0178, 0x0178, L, Folding::Offset, 0x00FF - 0x0178},
+    {0x0179, 0x017E, L, Folding::OddUpper, 0},
+    {0x017F, 0x017F, L, Folding::None, 0},
+    // Latin Extended-B: нерегулярные пары задаются поштучно
+    {0x0180, 0x0180, L, Folding::None, 0},
+    {0x0181, 0x0181, L, Folding::Offset, 0x0253 - 0x0181},
+    {0x0182, 0x0183, L, Folding::EvenUpper, 0},
+    {0x0184, 0x0185, L, Folding::EvenUpper, 0},
+    {0x0186, 0x0186, L, Folding::Offset, 0x0254 - 0x0186},
+    {0x0187, 0x0188, L, Folding::OddUpper, 0},
+    {0x0189, 0x0189, L, Folding::Offset, 0x0256 - 0x0189},
+    {0x018A, 0x018A, L, Folding::Offset, 0x0257 - 0x018A},
+    {0x018B, 0x018C, L, Folding::OddUpper, 0},
+    {0x018D, 0x018D, L, Folding::None, 0},
+    {0x018E, 0x018E, L, Folding::Offset, 0x01DD - 0x018E},
+    {0x018F, 0x018F, L, Folding::Offset, 0x0259 - 0x018F},
+    {0x0190, 0x0190, L, Folding::Offset, 0x025B - 0x0190},
+    {0x0191, 0x0192, L, Folding::OddUpper, 0},
+    {0x0193, 0x0193, L, Folding::Offset, 0x0260 - 0x0193},
+    {0x0194, 0x0194, L, Folding::Offset, 0x0263 - 0x0194},
+    {0x0195, 0x0195, L, Folding::None, 0},
+    {0x0196, 0x0196, L, Folding::Offset, 0x0269 - 0x0196},
+    {0x0197, 0x0197, L, Folding::Offset, 0x0268 - 0x0197},
+    {0x0198, 0x0199, L, Folding::EvenUpper, 0},
+    {0x019A, 0x019B, L, Folding::None, 0},
+    {0x019C, 0x019C, L, Folding::Offset, 0x026F - 0x019C},
+    {0x019D, 0x019D, L, Folding::Offset, 0x0272 - 0x019D},
+    {0x019E, 0x019E, L, Folding::None, 0},
+    {0x019F, 0x019F, L, Folding::Offset, 0x0275 - 0x019F},
+    {0x01A0, 0x01A5, L, Folding::EvenUpper, 0},
+    {0x01A6, 0x01A6, L, Folding::Offset, 0x0280 - 0x01A6},
+    {0x01A7, 0x01A8, L, Folding::OddUpper, 0},
+    {0x01A9, 0x01A9, L, Folding::Offset, 0x0283 - 0x01A9},
+    {0x01AA, 0x01AB, L, Folding::None, 0},
+    {0x01AC, 0x01AD, L, Folding::EvenUpper, 0},
+    {0x01AE, 0x01AE, L, Folding::Offset, 0x0288 - 0x01AE},
+    {0x01AF, 0x01B0, L, Folding::OddUpper, 0},
+    {0x01B1, 0x01B1, L, Folding::Offset, 0x028A - 0x01B1},
+    {0x01B2, 0x01B2, L, Folding::Offset, 0x028B - 0x01B2},
+    {0x01B3, 0x01B4, L, Folding::OddUpper, 0},
+    {0x01B5, 0x01B6, L, Folding::OddUpper, 0},
+    {0x01B7, 0x01B7, L, Folding::Offset, 0x0292 - 0x01B7},
+    {0x01B8, 0x01B9, L, Folding::EvenUpper, 0},
+    {0x01BA, 0x01BB, L, Folding::None, 0},
+    {0x01BC, 0x01BD, L, Folding::EvenUpper, 0},
+    {0x01BE, 0x01C3, L, Folding::None, 0},
+    {0x01C4, 0x01C4, L, Folding::Offset, 0x01C6 - 0x01C4},
+    {0x01C5, 0x01C5, L, Folding::Offset, 0x01C6 - 0x01C5},
+    {0x01C6, 0x01C6, L, Folding::None, 0},
+    {0x01C7, 0x01C7, L, Folding::Offset, 0x01C9 - 0x01C7},
+    {0x01C8, 0x01C8, L, Folding::Offset, 0x01C9 - 0x01C8},
+    {0x01C9, 0x01C9, L, Folding::None, 0},
+    {0x01CA, 0x01CA, L, Folding::Offset, 0x01CC - 0x01CA},
+    {0x01CB, 0x01CB, L, Folding::Offset, 0x01CC - 0x01CB},
+    {0x01CC, 0x01CC, L, Folding::None, 0},
+    {0x01CD, 0x01DC, L, Folding::OddUpper, 0},
+    {0x01DD, 0x01DD, L, Folding::None, 0},
+    {0x01DE, 0x01EF, L, Folding::EvenUpper, 0},
+    {0x01F0, 0x01F0, L, Folding::None, 0},
+    {0x01F1, 0x01F1, L, Folding::Offset, 0x01F3 - 0x01F1},
+    {0x01F2, 0x01F2, L, Folding::Offset, 0x01F3 - 0x01F2},
+    {0x01F3, 0x01F3, L, Folding::None, 0},
+    {0x01F4, 0x01F5, L, Folding::EvenUpper, 0},
+    {0x01F6, 0x01F6, L, Folding::Offset, 0x0195 - 0x01F6},
+    {0x01F7, 0x01F7, L, Folding::Offset, 0x01BF - 0x01F7},
+    {0x01F8, 0x021F, L, Folding::EvenUpper, 0},
+    {0x0220, 0x0220, L, Folding::Offset, 0x019E - 0x0220},
+    {0x0221, 0x0221, L, Folding::None, 0},
+    {0x0222, 0x0233, L, Folding::EvenUpper, 0},
+    {0x0234, 0x0239, L, Folding::None, 0},
+    {0x023A, 0x023A, L, Folding::Offset, 0x2C65 - 0x023A},
+    {0x023B, 0x023C, L, Folding::OddUpper, 0},
+    {0x023D, 0x023D, L, Folding::Offset, 0x019A - 0x023D},
+    {0x023E, 0x023E, L, Folding::Offset, 0x2C66 - 0x023E},
+    {0x023F, 0x0240, L, Folding::None, 0},
+    {0x0241, 0x0242, L, Folding::OddUpper, 0},
+    {0x0243, 0x0243, L, Folding::Offset, 0x0180 - 0x0243},
+    {0x0244, 0x0244, L, Folding::Offset, 0x0289 - 0x0244},
+    {0x0245, 0x0245, L, Folding::Offset, 0x028C - 0x0245},
+    {0x0246, 0x024F, L, Folding::EvenUpper, 0},
+    // IPA: только строчные
+    {0x0250, 0x02AF, L, Folding::None, 0},
+    // Комбинируемые диакритические знаки
+    {0x0300, 0x036F, M, Folding::None, 0},
+    // Греческий
+    {0x0370, 0x0373, L, Folding::EvenUpper, 0},
+    {0x0376, 0x0377, L, Folding::EvenUpper, 0},
+    {0x037B, 0x037D, L, Folding::None, 0},
+    {0x037F, 0x037F, L, Folding::Offset, 0x03F3 - 0x037F},
+    {0x0386, 0x0386, L, Folding::Offset, 0x03AC - 0x0386},
+    {0x0388, 0x038A, L, Folding::Offset, 0x03AD - 0x0388},
+    {0x038C, 0x038C, L, Folding::Offset, 0x03CC - 0x038C},
+    {0x038E, 0x038F, L, Folding::Offset, 0x03CD - 0x038E},
+    {0x0390, 0x0390, L, Folding::None, 0},
+    {0x0391, 0x03A1, L, Folding::Offset, 0x20},
+    {0x03A3, 0x03AB, L, Folding::Offset, 0x20},
+    {0x03AC, 0x03CE, L, Folding::None, 0},
+    {0x03CF, 0x03CF, L, Folding::Offset, 0x03D7 - 0x03CF},
+    {0x03D0, 0x03D7, L, Folding::None, 0},
+    {0x03D8, 0x03EF, L, Folding::EvenUpper, 0},
+    {0x03F0, 0x03F3, L, Folding::None, 0},
+    {0x03F4, 0x03F4, L, Folding::Offset, 0x03B8 - 0x03F4},
+    {0x03F5, 0x03F5, L, Folding::None, 0},
+    {0x03F7, 0x03F7, L, Folding::Offset, 0x03F8 - 0x03F7},
+    {0x03F8, 0x03F8, L, Folding::None, 0},
+    {0x03F9, 0x03F9, L, Folding::Offset, 0x03F2 - 0x03F9},
+    {0x03FA, 0x03FA, L, Folding::Offset, 0x03FB - 0x03FA},
+    {0x03FB, 0x03FC, L, Folding::None, 0},
+    {0x03FD, 0x03FF, L, Folding::Offset, 0x037B - 0x03FD},
+    // Кириллица
+    {0x0400, 0x040F, L, Folding::Offset, 0x50},
+    {0x0410, 0x042F, L, Folding::Offset, 0x20},
+    {0x0430, 0x045F, L, Folding::None, 0},
+    {0x0460, 0x0481, L, Folding::EvenUpper, 0},
+    {0x0483, 0x0489, M, Folding::None, 0},
+    {0x048A, 0x04BF, L, Folding::EvenUpper, 0},
+    {0x04C0, 0x04C0, L, Folding::Offset, 0x04CF - 0x04C0},
+    {0x04C1, 0x04CE, L, Folding::OddUpper, 0},
+    {0x04CF, 0x04CF, L, Folding::None, 0},
+    {0x04D0, 0x052F, L, Folding::EvenUpper, 0},
+    // Армянский
+    {0x0531, 0x0556, L, Folding::Offset, 0x30},
+    {0x0561, 0x0587, L, Folding::None, 0},
+    // Иврит: огласовки и знаки кантилляции продолжают слово
+    {0x0591, 0x05BD, M, Folding::None, 0},
+    {0x05BF, 0x05BF, M, Folding::None, 0},
+    {0x05C1, 0x05C2, M, Folding::None, 0},
+    {0x05C4, 0x05C5, M, Folding::None, 0},
+    {0x05C7, 0x05C7, M, Folding::None, 0},
+    {0x05D0, 0x05EA, L, Folding::None, 0},
+    // Арабский: харакаты - комбинируемые знаки
+    {0x0610, 0x061A, M, Folding::None, 0},
+    {0x0620, 0x064A, L, Folding::None, 0},
+    {0x064B, 0x065F, M, Folding::None, 0},
+    {0x0660, 0x0669, D, Folding::None, 0},
+    {0x0670, 0x0670, M, Folding::None, 0},
+    {0x0671, 0x06D3, L, Folding::None, 0},
+    {0x06D6, 0x06DC, M, Folding::None, 0},
+    {0x06DF, 0x06E4, M, Folding::None, 0},
+    {0x06E7, 0x06E8, M, Folding::None, 0},
+    {0x06EA, 0x06ED, M, Folding::None, 0},
+    {0x06F0, 0x06F9, D, Folding::None, 0},
+    // Деванагари: матры, вирама и другие знаки продолжают слово
+    {0x0900, 0x0903, M, Folding::None, 0},
+    {0x0904, 0x0939, L, Folding::None, 0},
+    {0x093A, 0x093C, M, Folding::None, 0},
+    {0x093D, 0x093D, L, Folding::None, 0},
+    {0x093E, 0x094F, M, Folding::None, 0},
+    {0x0950, 0x0950, L, Folding::None, 0},
+    {0x0951, 0x0957, M, Folding::None, 0},
+    {0x0958, 0x0961, L, Folding::None, 0},
+    {0x0962, 0x0963, M, Folding::None, 0},
+    {0x0966, 0x096F, D, Folding::None, 0},
+    {0x0971, 0x097F, L, Folding::None, 0},
+    // Грузинский: асомтаврули приводится к нусхури, мтаврули - к мхедрули
+    {0x10A0, 0x10C5, L, Folding::Offset, 0x2D00 - 0x10A0},
+    {0x10C6, 0x10C6, L, Folding::None, 0},
+    {0x10C7, 0x10C7, L, Folding::Offset, 0x2D27 - 0x10C7},
+    {0x10C8, 0x10CC, L, Folding::None, 0},
+    {0x10CD, 0x10CD, L, Folding::Offset, 0x2D2D - 0x10CD},
+    {0x10CE, 0x10FF, L, Folding::None, 0},
+    // Расширения комбинируемых знаков
+    {0x1AB0, 0x1AFF, M, Folding::None, 0},
+    {0x1C90, 0x1CBA, L, Folding::Offset, 0x10D0 - 0x1C90},
+    {0x1CBD, 0x1CBF, L, Folding::Offset, 0x10FD - 0x1CBD},
+    {0x1DC0, 0x1DFF, M, Folding::None, 0},
+    // Latin Extended Additional
+    {0x1E00, 0x1E95, L, Folding::EvenUpper, 0},
+    {0x1E96, 0x1E9D, L, Folding::None, 0},
+    {0x1E9E, 0x1E9E, L, Folding::Offset, 0x00DF - 0x1E9E},
+    {0x1E9F, 0x1E9F, L, Folding::None, 0},
+    {0x1EA0, 0x1EFF, L, Folding::EvenUpper, 0},
+    {0x20D0, 0x20FF, M, Folding::None, 0},
+    {0x2D00, 0x2D2D, L, Folding::None, 0},
+    // Японские азбуки, CJK, хангыль
+    {0x3041, 0x3096, L, Folding::None, 0},
+    {0x3099, 0x309A, M, Folding::None, 0},
+    {0x30A1, 0x30FA, L, Folding::None, 0},
+    {0x3400, 0x4DBF, L, Folding::None, 0},
+    {0x4E00, 0x9FFF, L, Folding::None, 0},
+    {0xAC00, 0xD7A3, L, Folding::None, 0},
+    {0xFE20, 0xFE2F, M, Folding::None, 0},
+    // Полноширинные цифры и латиница
+    {0xFF10, 0xFF19, D, Folding::None, 0},
+    {0xFF21, 0xFF3A, L, Folding::Offset, 0x20},
+    {0xFF41, 0xFF5A, L, Folding::None, 0},
+};
+
+}
+
+size_t Unicode::decode(const char* data, size_t size, char32_t& codePoint) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    codePoint = REPLACEMENT;
+    if (size == 0) {
+        return 0;
+    }
+
+    unsigned char lead = p[0];
+    if (lead < 0x80) {
+        codePoint = lead;
+        return 1;
+    }
+
+    size_t length;
+    char32_t value;
+    char32_t minimum;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 2;
+        value = lead & 0x1F;
+        minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 3;
+        value = lead & 0x0F;
+        minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 4;
+        value = lead & 0x07;
+        minimum = 0x10000;
+    } else {
+        return 1;
+    }
+
+    if (size < length) {
+        return 1;
+    }
+    for (size_t i = 1; i < length; ++i) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 1;
+        }
+        value = (value << 6) | (p[i] & 0x3F);
+    }
+
+    // Избыточная запись, суррогаты и значения за пределами Unicode некорректны
+    if (value < minimum || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
+        return 1;
+    }
+
+    codePoint = value;
+    return length;
+}
+
+size_t Unicode::encode(char32_t codePoint, char* out) {
+    if (codePoint < 0x80) {
+        out[0] = static_cast<char>(codePoint);
+        return 1;
+    }
+    if (codePoint < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+        out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    if (codePoint < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+        out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+    out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+Unicode::CharClass Unicode::classify(char32_t codePoint, char32_t& lower) {
+    lower = codePoint;
+
+    // Первый диапазон, который заканчивается не раньше codePoint
+    const Range* range = std::lower_bound(
+        std::begin(RANGES), std::end(RANGES), codePoint,
+        [](const Range& r, char32_t value) { return r.last < value; }
+    );
+    if (range == std::end(RANGES) || codePoint < range->first) {
+        return CharClass::Other;
+    }
+
+    switch (range->folding) {
+    case Folding::Offset:
+        lower = codePoint + range->delta;
+        break;
+    case Folding::EvenUpper:
+        if (codePoint % 2 == 0) {
+            lower = codePoint + 1;
+        }
+        break;
+    case Folding::OddUpper:
+        if (codePoint % 2 == 1) {
+            lower = codePoint + 1;
+        }
+        break;
+    case Folding::None:
+        break;
+    }
+    return range->charClass;
+}
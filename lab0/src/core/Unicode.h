@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+// Декодирование UTF-8 и классификация символов Unicode для разбора слов.
+// Таблица символов компактная: упорядоченный список диапазонов, в котором
+// ищется код символа. Она покрывает латиницу (включая Latin-1 и расширения),
+// греческий, кириллицу, армянский, грузинский, иврит, арабский, деванагари,
+// японские слоговые азбуки, CJK и хангыль. Комбинируемые знаки (диакритика,
+// огласовки иврита, харакаты, матры и вирама деванагари) продолжают слово,
+// но не начинают его. Символы вне таблицы считаются разделителями.
+class Unicode {
+public:
+    enum class CharClass {
+        Other,
+        Letter,
+        Digit,
+        Mark    // Комбинируемый знак: продолжает начатое слово
+    };
+
+    // Замена для некорректных последовательностей
+    static constexpr char32_t REPLACEMENT = 0xFFFD;
+
+    // Декодировать символ в начале буфера. Возвращает число прочитанных байтов
+    // (не меньше 1); некорректная последовательность дает REPLACEMENT
+    static size_t decode(const char* data, size_t size, char32_t& codePoint);
+
+    // Закодировать символ в UTF-8 (out - не меньше 4 байт), вернуть длину
+    static size_t encode(char32_t codePoint, char* out);
+
+    // Класс символа; для букв в lower записывается строчная форма
+    static CharClass classify(char32_t codePoint, char32_t& lower);
+};
@@ -1,44 +1,225 @@
 #include "WordCounter.h"
 #include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include "FlatWordTable.h"
+#include "TreeWordTable.h"
 
-WordCounter::WordCounter() {}
+namespace {
 
-void WordCounter::addWord(const std::string& word) {
+// Частоты меньше этой раскладываются сортировкой подсчетом
+constexpr uint64_t COUNTING_SORT_LIMIT = 1 << 16;
+
+// Номер корзины для частоты: корзина 0 - наибольшая частота
+size_t bucketIndex(uint64_t frequency, size_t bucketCount) {
+    return bucketCount - 1 - static_cast<size_t>(frequency);
+}
+
+// Слово вместе с первыми восемью байтами, упакованными в число так, что
+// порядок чисел совпадает с порядком строк
+struct PrefixedEntry {
+    uint64_t prefix;
+    WordCounter::Entry entry;
+};
+
+uint64_t wordPrefix(std::string_view word) {
+    uint64_t prefix = 0;
+    size_t n = std::min<size_t>(word.size(), 8);
+    for (size_t i = 0; i < n; ++i) {
+        prefix |= static_cast<uint64_t>(static_cast<unsigned char>(word[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+// Отсортировать слова одной корзины по алфавиту. Большинство сравнений
+// решается по числовому префиксу, без обращения к байтам слов
+void sortByWord(
+    std::vector<WordCounter::Entry>::iterator first,
+    std::vector<WordCounter::Entry>::iterator last,
+    std::vector<PrefixedEntry>& buffer
+) {
+    if (last - first < 2) {
+        return;
+    }
+    buffer.clear();
+    for (auto it = first; it != last; ++it) {
+        buffer.push_back(PrefixedEntry{wordPrefix(it->first), *it});
+    }
+    std::sort(buffer.begin(), buffer.end(), [](const PrefixedEntry& a, const PrefixedEntry& b) {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix;
+        }
+        return a.entry.first < b.entry.first;
+    });
+    for (const PrefixedEntry& item : buffer) {
+        *first++ = item.entry;
+    }
+}
+
+}
+
+WordCounter::WordCounter(Backend backend) : backend_(backend), totalWords(0) {
+    if (backend == Backend::Hash || backend == Backend::Compact) {
+        wordFrequency = std::make_unique<FlatWordTable>(backend == Backend::Compact);
+    } else {
+        wordFrequency = std::make_unique<TreeWordTable>();
+    }
+}
+
+void WordCounter::addWord(std::string_view word) {
     if (!word.empty()) {
-        wordFrequency[word]++;
+        wordFrequency->add(word, 1);
+        totalWords++;
     }
 }
 
-int WordCounter::getFrequency(const std::string& word) const {
-    auto it = wordFrequency.find(word);
-    if (it != wordFrequency.end()) {
-        return it->second;
+void WordCounter::merge(const WordCounter& other) {
+    WordTable& table = *wordFrequency;
+    other.wordFrequency->forEach([&table](std::string_view word, uint64_t frequency) {
+        table.add(word, frequency);
+    });
+    totalWords += other.totalWords;
+}
+
+void WordCounter::saveSnapshot(const std::string& filename) const {
+    // Слова загруженного снимка могут указывать в отображение того же файла,
+    // поэтому снимок пишется во временный файл и только потом заменяет старый
+    const std::string tempFilename = filename + ".tmp";
+    std::ofstream file(tempFilename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + tempFilename);
+    }
+
+    if (backend_ != Backend::Tree) {
+        static_cast<const FlatWordTable&>(*wordFrequency).saveSnapshot(file);
+    } else {
+        // Снимок всегда хранит хеш-таблицу, чтобы ее можно было загрузить без перестроения
+        FlatWordTable table;
+        wordFrequency->forEach([&table](std::string_view word, uint64_t frequency) {
+            table.add(word, frequency);
+        });
+        table.saveSnapshot(file);
+    }
+
+    file.close();
+    std::error_code error;
+    if (!file.fail()) {
+        std::filesystem::rename(tempFilename, filename, error);
+    }
+    if (file.fail() || error) {
+        std::filesystem::remove(tempFilename, error);
+        throw std::runtime_error("Cannot write file: " + filename);
     }
-    return 0;
 }
 
-std::vector<std::pair<std::string, int>> WordCounter::getSortedWords() const {
-    // Создаем вектор пар из map для сортировки
-    std::vector<std::pair<std::string, int>> result(
-        wordFrequency.begin(),
-        wordFrequency.end()
-    );
+void WordCounter::loadSnapshot(const std::string& filename) {
+    MappedFile file(filename);
+
+    if (backend_ != Backend::Tree && wordFrequency->size() == 0) {
+        static_cast<FlatWordTable&>(*wordFrequency).loadSnapshot(std::move(file));
+        uint64_t total = 0;
+        wordFrequency->forEach([&total](std::string_view, uint64_t frequency) {
+            total += frequency;
+        });
+        totalWords = total;
+        return;
+    }
+
+    WordTable& table = *wordFrequency;
+    uint64_t& total = totalWords;
+    FlatWordTable::readSnapshot(file, [&table, &total](std::string_view word, uint64_t frequency) {
+        table.add(word, frequency);
+        total += frequency;
+    });
+}
+
+uint64_t WordCounter::getFrequency(std::string_view word) const {
+    return wordFrequency->find(word);
+}
+
+std::vector<WordCounter::Entry> WordCounter::getSortedWords() const {
+    // Собираем пары из таблицы в вектор для сортировки
+    std::vector<Entry> words;
+    words.reserve(wordFrequency->size());
+    uint64_t maxFrequency = 0;
+    wordFrequency->forEach([&words, &maxFrequency](std::string_view word, uint64_t frequency) {
+        words.emplace_back(word, frequency);
+        maxFrequency = std::max(maxFrequency, frequency);
+    });
+
+    // Частоты - небольшие числа, и почти все слова встречаются редко, поэтому
+    // слова раскладываются сортировкой подсчетом по частоте. Немногие слова
+    // с частотой от COUNTING_SORT_LIMIT сортируются сравнением и идут первыми
+    size_t bucketCount = static_cast<size_t>(std::min(maxFrequency, COUNTING_SORT_LIMIT - 1)) + 1;
+    std::vector<size_t> start(bucketCount + 1, 0);
+    std::vector<Entry> large;
+    for (const Entry& entry : words) {
+        if (entry.second >= COUNTING_SORT_LIMIT) {
+            large.push_back(entry);
+        } else {
+            start[bucketIndex(entry.second, bucketCount)]++;
+        }
+    }
+    std::sort(large.begin(), large.end(), WordCounter::comesBefore);
+
+    // Начало каждой корзины; корзины идут по убыванию частоты
+    size_t position = large.size();
+    for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+        size_t count = start[bucket];
+        start[bucket] = position;
+        position += count;
+    }
+    start[bucketCount] = position;
 
-    // Сортируем по убыванию частоты
-    std::sort(result.begin(), result.end(),
-        [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) {
-            return a.second > b.second;
+    std::vector<Entry> result(words.size());
+    std::copy(large.begin(), large.end(), result.begin());
+    std::vector<size_t> next(start.begin(), start.end() - 1);
+    for (const Entry& entry : words) {
+        if (entry.second < COUNTING_SORT_LIMIT) {
+            result[next[bucketIndex(entry.second, bucketCount)]++] = entry;
         }
-    );
+    }
+
+    // Раскладка устойчива: если таблица обходит слова по алфавиту, внутри
+    // корзин они уже упорядочены. Иначе сортируем каждую корзину по словам
+    if (!wordFrequency->isOrdered()) {
+        std::vector<PrefixedEntry> prefixed;
+        for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+            sortByWord(result.begin() + start[bucket], result.begin() + start[bucket + 1], prefixed);
+        }
+    }
 
     return result;
 }
 
-int WordCounter::getTotalWords() const {
-    int total = 0;
-    for (const auto& pair : wordFrequency) {
-        total += pair.second;
+std::vector<WordCounter::Entry> WordCounter::getTopK(size_t k) const {
+    // Куча из k лучших слов; на вершине - худшее из них
+    std::vector<Entry> heap;
+    if (k > 0) {
+        heap.reserve(std::min(k, wordFrequency->size()));
+        wordFrequency->forEach([&heap, k](std::string_view word, uint64_t frequency) {
+            Entry entry(word, frequency);
+            if (heap.size() < k) {
+                heap.push_back(entry);
+                std::push_heap(heap.begin(), heap.end(), WordCounter::comesBefore);
+            } else if (WordCounter::comesBefore(entry, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), WordCounter::comesBefore);
+                heap.back() = entry;
+                std::push_heap(heap.begin(), heap.end(), WordCounter::comesBefore);
+            }
+        });
     }
-    return total;
+
+    std::sort_heap(heap.begin(), heap.end(), WordCounter::comesBefore);
+    return heap;
 }
 
+size_t WordCounter::getDistinctWords() const {
+    return wordFrequency->size();
+}
+
+size_t WordCounter::getMemoryUsage() const {
+    return wordFrequency->memoryUsage();
+}
@@ -1,27 +1,76 @@
 #pragma once
-#include <string>
-#include <map>
+#include <cstdint>
+#include <memory>
+#include <string_view>
 #include <vector>
 #include <utility>
+#include "WordTable.h"
 
 class WordCounter {
+public:
+    // Способ хранения таблицы частот
+    enum class Backend {
+        Tree,   // std::map, слова упорядочены
+        Hash,   // хеш-таблица с открытой адресацией
+        Compact // та же хеш-таблица, но частоты занимают 32 бита, пока помещаются в них
+    };
+
+    // Слово и его частота. Слово указывает в память счетчика и действительно,
+    // пока счетчик существует
+    using Entry = std::pair<std::string_view, uint64_t>;
+
+    // Порядок вывода: по убыванию частоты, при равенстве - по алфавиту.
+    // Общий для всех счетчиков, включая приближенный и n-граммы
+    static bool comesBefore(const Entry& a, const Entry& b) {
+        if (a.second != b.second) {
+            return a.second > b.second;
+        }
+        return a.first < b.first;
+    }
+
 private:
-    std::map<std::string, int> wordFrequency;
+    Backend backend_;
+    std::unique_ptr<WordTable> wordFrequency;
+    // Сумма всех частот, обновляется при каждом добавлении
+    uint64_t totalWords;
 
 public:
-    WordCounter();
+    explicit WordCounter(Backend backend = Backend::Tree);
 
     // Добавить слово в счетчик
-    void addWord(const std::string& word);
+    void addWord(std::string_view word);
+
+    // Прибавить к счетчику все частоты другого счетчика
+    void merge(const WordCounter& other);
+
+    // Сохранить таблицу частот в двоичный снимок
+    void saveSnapshot(const std::string& filename) const;
+
+    // Загрузить снимок, прибавив его частоты к счетчику. Пустой счетчик с
+    // хеш-таблицей принимает снимок как есть, без перестроения таблицы
+    void loadSnapshot(const std::string& filename);
 
     // Получить частоту слова
-    int getFrequency(const std::string& word) const;
+    uint64_t getFrequency(std::string_view word) const;
 
-    // Получить все слова и их частоты отсортированные по убыванию (в виде вектора пар)
-    std::vector<std::pair<std::string, int>> getSortedWords() const;
+    // Получить все слова и их частоты отсортированные по убыванию
+    // (слова с одинаковой частотой - по алфавиту). Слова не копируются.
+    // Используется сортировка подсчетом по частоте, а не сравнением
+    std::vector<Entry> getSortedWords() const;
 
-    // Получить общее количество слов
-    int getTotalWords() const;
-};
+    // Получить k самых частых слов в том же порядке, что и getSortedWords.
+    // Полная сортировка не выполняется: слова проходят через кучу размера k
+    std::vector<Entry> getTopK(size_t k) const;
+
+    // Получить общее количество слов (хранится, а не пересчитывается)
+    uint64_t getTotalWords() const { return totalWords; }
 
+    // Получить количество различных слов
+    size_t getDistinctWords() const;
 
+    // Сколько байтов занимает таблица частот
+    size_t getMemoryUsage() const;
+
+    // Способ хранения, выбранный при создании
+    Backend getBackend() const { return backend_; }
+};
@@ -0,0 +1,4 @@
+#include "WordFilter.h"
+#include <utility>
+
+WordFilter::WordFilter(StopWords words, bool stemWords) : stopWords(std::move(words)), stem(stemWords) {}
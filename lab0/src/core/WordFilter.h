@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string_view>
+#include "Stemmer.h"
+#include "StopWords.h"
+
+// Стадия между разбором слов и счетчиком: отбрасывает стоп-слова и, если
+// включено, заменяет слово его основой. Не меняет состояния, поэтому один
+// фильтр можно использовать из нескольких потоков.
+class WordFilter {
+private:
+    StopWords stopWords;
+    bool stem;
+
+public:
+    WordFilter(StopWords stopWords, bool stem);
+
+    // Пропустить слово через фильтр. false - слово не считается; иначе
+    // word может быть укорочен до основы
+    bool apply(std::string_view& word) const {
+        if (stopWords.size() > 0 && stopWords.contains(word)) {
+            return false;
+        }
+        if (stem) {
+            word = Stemmer::stem(word);
+        }
+        return true;
+    }
+};
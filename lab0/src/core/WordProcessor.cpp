@@ -1,50 +1,248 @@
 #include "WordProcessor.h"
-#include <cctype>
-#include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include "../io/MappedFile.h"
 
-std::vector<std::string> WordProcessor::extractWords(const std::string& line) {
+namespace {
+
+// Размер блока, который учитывается в гистограммах и сразу разбирается на слова
+constexpr size_t HISTOGRAM_BLOCK_SIZE = 64 * 1024;
+
+}
+
+std::vector<std::string> WordProcessor::extractWords(const std::string& line, Encoding encoding) {
     std::vector<std::string> words;
-    std::string currentWord;
-
-    for (char c : line) {
-        // Проверяем, является ли символ буквой или цифрой
-        if (std::isalnum(static_cast<unsigned char>(c))) {
-            currentWord += c;
-        } else {
-            // Это разделитель
-            if (!currentWord.empty()) {
-                words.push_back(toLower(currentWord));
-                currentWord.clear();
-            }
-        }
-    }
 
-    // Добавляем последнее слово, если оно есть
-    if (!currentWord.empty()) {
-        words.push_back(toLower(currentWord));
-    }
+    // Сканер сразу отдает слова в нижнем регистре
+    WordScanner::scan(line.data(), line.size(), [&words](std::string_view word) {
+        words.emplace_back(word);
+    }, encoding);
 
     return words;
 }
 
 void WordProcessor::processLines(
     const std::vector<std::string>& lines,
-    WordCounter& counter
+    WordCounter& counter,
+    Encoding encoding
 ) {
     for (const auto& line : lines) {
-        std::vector<std::string> words = extractWords(line);
-        for (const auto& word : words) {
+        WordScanner::scan(line.data(), line.size(), [&counter](std::string_view word) {
             counter.addWord(word);
+        }, encoding);
+    }
+}
+
+void WordProcessor::processLines(
+    const std::vector<std::string>& lines,
+    WordCounter& counter,
+    const Extras& extras,
+    Encoding encoding,
+    bool lastLineTerminated
+) {
+    for (size_t i = 0; i < lines.size(); ++i) {
+        processBuffer(lines[i].data(), lines[i].size(), counter, extras, encoding);
+        // Учитываются только переводы строк, которые были во входе
+        bool terminated = lastLineTerminated || i + 1 < lines.size();
+        if (extras.histograms != nullptr && terminated) {
+            extras.histograms->addBytes("\n", 1);
+        }
+    }
+}
+
+void WordProcessor::processBuffer(
+    const char* data,
+    size_t size,
+    WordCounter& counter,
+    Encoding encoding
+) {
+    // Слова передаются в счетчик прямо из блока сканера
+    WordScanner::scan(data, size, [&counter](std::string_view word) {
+        counter.addWord(word);
+    }, encoding);
+}
+
+void WordProcessor::processBuffer(
+    const char* data,
+    size_t size,
+    WordCounter& counter,
+    const Extras& extras,
+    Encoding encoding
+) {
+    auto onWord = [&counter, &extras](std::string_view word) {
+        if (extras.filter != nullptr && !extras.filter->apply(word)) {
+            return;
+        }
+        counter.addWord(word);
+        if (extras.ngrams != nullptr) {
+            extras.ngrams->addWord(word);
+        }
+        if (extras.histograms != nullptr) {
+            extras.histograms->addWord(word);
         }
+    };
+
+    if (extras.histograms == nullptr) {
+        WordScanner::scan(data, size, onWord, encoding);
+        return;
+    }
+
+    // Блок заканчивается на разделителе, чтобы слова не разрезались;
+    // слово длиннее блока целиком уходит в один блок
+    size_t start = 0;
+    while (start < size) {
+        size_t end = std::min(size, start + HISTOGRAM_BLOCK_SIZE);
+        if (end < size) {
+            size_t cut = end;
+            while (cut > start && !WordScanner::isBoundary(data[cut - 1])) {
+                --cut;
+            }
+            if (cut == start) {
+                while (end < size && !WordScanner::isBoundary(data[end])) {
+                    ++end;
+                }
+            } else {
+                end = cut;
+            }
+        }
+        extras.histograms->addBytes(data + start, end - start);
+        WordScanner::scan(data + start, end - start, onWord, encoding);
+        start = end;
     }
 }
 
-std::string WordProcessor::toLower(const std::string& word) {
-    std::string result = word;
-    std::transform(result.begin(), result.end(), result.begin(),
-        [](unsigned char c) { return std::tolower(c); }
-    );
-    return result;
+void WordProcessor::processBuffer(
+    const char* data,
+    size_t size,
+    ApproximateCounter& counter,
+    Encoding encoding,
+    const WordFilter* filter
+) {
+    WordScanner::scan(data, size, [&counter, filter](std::string_view word) {
+        if (filter == nullptr || filter->apply(word)) {
+            counter.addWord(word);
+        }
+    }, encoding);
+}
+
+void WordProcessor::processBufferParallel(
+    const char* data,
+    size_t size,
+    WordCounter& counter,
+    unsigned threadCount,
+    Encoding encoding,
+    const WordFilter* filter
+) {
+    Extras extras;
+    extras.filter = filter;
+    if (threadCount <= 1 || size == 0) {
+        processBuffer(data, size, counter, extras, encoding);
+        return;
+    }
+
+    // Делим буфер на примерно равные части. Граница сдвигается вперед до
+    // ближайшего ASCII разделителя, чтобы ни одно слово (и ни один
+    // многобайтовый символ UTF-8) не оказалось разрезано
+    std::vector<size_t> bounds;
+    bounds.push_back(0);
+    for (unsigned i = 1; i < threadCount; ++i) {
+        size_t pos = std::max(bounds.back(), size / threadCount * i);
+        while (pos < size && !WordScanner::isBoundary(data[pos])) {
+            ++pos;
+        }
+        bounds.push_back(pos);
+    }
+    bounds.push_back(size);
+
+    // Каждый поток пишет только в свой счетчик, поэтому синхронизация не нужна
+    std::vector<WordCounter> partial;
+    partial.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        partial.emplace_back(counter.getBackend());
+    }
+
+    // Исключение из потока передаем в вызывающий поток
+    std::vector<std::exception_ptr> errors(threadCount);
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back([data, &bounds, &partial, &errors, &extras, i, encoding]() {
+            try {
+                processBuffer(data + bounds[i], bounds[i + 1] - bounds[i], partial[i], extras, encoding);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Сливаем частичные результаты
+    for (const auto& part : partial) {
+        counter.merge(part);
+    }
 }
 
+uint64_t WordProcessor::processFiles(
+    const std::vector<std::string>& files,
+    WordCounter& counter,
+    unsigned threadCount,
+    Encoding encoding,
+    const WordFilter* filter
+) {
+    Extras extras;
+    extras.filter = filter;
+    threadCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threadCount, files.size())));
+
+    std::vector<WordCounter> partial;
+    partial.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        partial.emplace_back(counter.getBackend());
+    }
+
+    // Номер следующего необработанного файла; после ошибки остальные файлы пропускаются
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> totalBytes{0};
+    std::vector<std::exception_ptr> errors(threadCount);
+    auto work = [&files, &partial, &errors, &next, &totalBytes, &extras, encoding](unsigned i) {
+        try {
+            for (size_t index = next++; index < files.size(); index = next++) {
+                MappedFile file(files[index]);
+                processBuffer(file.data(), file.size(), partial[i], extras, encoding);
+                totalBytes += file.size();
+            }
+        } catch (...) {
+            errors[i] = std::current_exception();
+            next = files.size();
+        }
+    };
+
+    // Текущий поток тоже работает, поэтому создаем на один поток меньше
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; ++i) {
+        workers.emplace_back(work, i);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    for (const auto& part : partial) {
+        counter.merge(part);
+    }
+    return totalBytes;
+}
@@ -1,23 +1,112 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
+#include "ApproximateCounter.h"
+#include "CorpusHistograms.h"
+#include "NGramCounter.h"
+#include "WordFilter.h"
 #include "WordCounter.h"
+#include "WordScanner.h"
 
+// Кодировка входа задается параметром encoding: по умолчанию словом
+// считаются ASCII буквы и цифры, в режиме Utf8 - буквы и цифры Unicode
 class WordProcessor {
 public:
+    using Encoding = WordScanner::Encoding;
+
+    // Дополнительные стадии, которые выполняются в том же проходе, что и
+    // подсчет слов. nullptr - стадия выключена. Фильтр применяется к слову
+    // до всех счетчиков
+    struct Extras {
+        const WordFilter* filter = nullptr;
+        NGramCounter* ngrams = nullptr;
+        CorpusHistograms* histograms = nullptr;
+
+        bool empty() const { return filter == nullptr && ngrams == nullptr && histograms == nullptr; }
+    };
+
     // Извлечь слова из строки (разделителями считаются все не буквы и не цифры)
-    static std::vector<std::string> extractWords(const std::string& line);
+    static std::vector<std::string> extractWords(
+        const std::string& line,
+        Encoding encoding = Encoding::Ascii
+    );
 
     // Обработать все строки и заполнить счетчик
     static void processLines(
         const std::vector<std::string>& lines,
-        WordCounter& counter
+        WordCounter& counter,
+        Encoding encoding = Encoding::Ascii
     );
 
-private:
-    // Преобразовать слово в нижний регистр
-    static std::string toLower(const std::string& word);
+    // То же, но за тот же проход заполняются и дополнительные подсчеты.
+    // Строки считаются завершенными переводом строки, кроме последней,
+    // если lastLineTerminated == false
+    static void processLines(
+        const std::vector<std::string>& lines,
+        WordCounter& counter,
+        const Extras& extras,
+        Encoding encoding = Encoding::Ascii,
+        bool lastLineTerminated = true
+    );
+
+    // Разобрать буфер (например, отображенный в память файл) и заполнить счетчик.
+    // Слова берутся прямо из буфера, без копирования строк и выделения памяти на слово
+    static void processBuffer(
+        const char* data,
+        size_t size,
+        WordCounter& counter,
+        Encoding encoding = Encoding::Ascii
+    );
+
+    // Разобрать буфер, заполнив за один проход счетчик слов и дополнительные
+    // подсчеты. Последовательные вызовы продолжают n-граммы и строки с конца
+    // предыдущего буфера. Для гистограмм буфер разбирается блоками, которые
+    // помещаются в кэш: байты блока учитываются перед разбором его слов,
+    // поэтому память читается один раз
+    static void processBuffer(
+        const char* data,
+        size_t size,
+        WordCounter& counter,
+        const Extras& extras,
+        Encoding encoding = Encoding::Ascii
+    );
+
+    // Разобрать буфер и передать слова в приближенный счетчик
+    static void processBuffer(
+        const char* data,
+        size_t size,
+        ApproximateCounter& counter,
+        Encoding encoding = Encoding::Ascii,
+        const WordFilter* filter = nullptr
+    );
+
+    // То же, что processBuffer, но буфер делится на threadCount частей по
+    // границам слов, каждая часть считается в своем потоке в отдельный
+    // счетчик, а затем результаты сливаются в counter. filter, если задан,
+    // применяется к словам во всех потоках
+    static void processBufferParallel(
+        const char* data,
+        size_t size,
+        WordCounter& counter,
+        unsigned threadCount,
+        Encoding encoding = Encoding::Ascii,
+        const WordFilter* filter = nullptr
+    );
+
+    // Посчитать слова во всех файлах. threadCount потоков по очереди берут
+    // следующий файл из общего списка, отображают его в память и считают в
+    // свой счетчик: пока один поток ждет диск, остальные считают. В конце
+    // счетчики сливаются в counter. Возвращает суммарный размер файлов
+    static uint64_t processFiles(
+        const std::vector<std::string>& files,
+        WordCounter& counter,
+        unsigned threadCount,
+        Encoding encoding = Encoding::Ascii,
+        const WordFilter* filter = nullptr
+    );
 };
 
 
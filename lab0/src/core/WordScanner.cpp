@@ -0,0 +1,183 @@
+#include "WordScanner.h"
+#include <cstring>
+
+// Векторные реализации собираются только для x86-64, где SSE2 есть всегда
+#if defined(__x86_64__) || defined(_M_X64)
+#define WORD_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(WORD_SCANNER_X86) && !defined(_MSC_VER)
+#define WORD_SCANNER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define WORD_SCANNER_TARGET_AVX2
+#endif
+
+namespace {
+
+// Таблицы для скалярной реализации: признак буквы/цифры и нижний регистр
+struct ScalarTables {
+    bool isWordChar[256];
+    char lower[256];
+
+    ScalarTables() {
+        for (int c = 0; c < 256; ++c) {
+            bool digit = c >= '0' && c <= '9';
+            bool upper = c >= 'A' && c <= 'Z';
+            bool lowerLetter = c >= 'a' && c <= 'z';
+            isWordChar[c] = digit || upper || lowerLetter;
+            lower[c] = static_cast<char>(upper ? c + ('a' - 'A') : c);
+        }
+    }
+};
+
+const ScalarTables& scalarTables() {
+    static const ScalarTables tables;
+    return tables;
+}
+
+void classifyScalar(const char* src, size_t begin, size_t size, char* lowered, uint64_t* mask) {
+    const ScalarTables& tables = scalarTables();
+    for (size_t i = begin; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(src[i]);
+        lowered[i] = tables.lower[c];
+        if (tables.isWordChar[c]) {
+            mask[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+}
+
+#ifdef WORD_SCANNER_X86
+
+// Байты в диапазоне [lo, hi]. В SSE2 есть только знаковое сравнение, поэтому
+// диапазон сдвигается так, чтобы lo стал -128, и сравнивается с его концом
+inline __m128i inRange128(__m128i v, char lo, char hi) {
+    __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(-128 - lo)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + (hi - lo) + 1)));
+}
+
+void classifySSE2(const char* src, size_t size, char* lowered, uint64_t* mask) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i upper = inRange128(v, 'A', 'Z');
+        __m128i lower = _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+        __m128i word = _mm_or_si128(inRange128(lower, 'a', 'z'), inRange128(v, '0', '9'));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lowered + i), lower);
+        uint64_t bits = static_cast<uint32_t>(_mm_movemask_epi8(word));
+        mask[i / 64] |= bits << (i % 64);
+    }
+    classifyScalar(src, i, size, lowered, mask);
+}
+
+WORD_SCANNER_TARGET_AVX2
+inline __m256i inRange256(__m256i v, char lo, char hi) {
+    __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(-128 - lo)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + (hi - lo) + 1)), shifted);
+}
+
+WORD_SCANNER_TARGET_AVX2
+void classifyAVX2(const char* src, size_t size, char* lowered, uint64_t* mask) {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i upper = inRange256(v, 'A', 'Z');
+        __m256i lower = _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+        __m256i word = _mm256_or_si256(inRange256(lower, 'a', 'z'), inRange256(v, '0', '9'));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lowered + i), lower);
+        uint64_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(word));
+        mask[i / 64] |= bits << (i % 64);
+    }
+    classifyScalar(src, i, size, lowered, mask);
+}
+
+bool cpuHasAVX2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // ОС должна сохранять регистры YMM при переключении контекста
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+}
+
+bool WordScanner::isAscii(const char* data, size_t size) {
+    // Проверяем старшие биты по 8 байт за раз
+    uint64_t accumulated = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, data + i, 8);
+        accumulated |= chunk;
+    }
+    for (; i < size; ++i) {
+        accumulated |= static_cast<unsigned char>(data[i]);
+    }
+    return (accumulated & 0x8080808080808080ULL) == 0;
+}
+
+bool WordScanner::isSupported(Implementation impl) {
+    switch (impl) {
+    case Implementation::Scalar:
+        return true;
+#ifdef WORD_SCANNER_X86
+    case Implementation::SSE2:
+        return true;
+    case Implementation::AVX2: {
+        static const bool hasAVX2 = cpuHasAVX2();
+        return hasAVX2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+WordScanner::Implementation WordScanner::best() {
+    static const Implementation detected =
+        isSupported(Implementation::AVX2) ? Implementation::AVX2 :
+        isSupported(Implementation::SSE2) ? Implementation::SSE2 :
+        Implementation::Scalar;
+    return detected;
+}
+
+void WordScanner::classify(
+    Implementation impl,
+    const char* src,
+    size_t size,
+    char* lowered,
+    uint64_t* mask
+) {
+    std::memset(mask, 0, (size + 63) / 64 * sizeof(uint64_t));
+
+    switch (impl) {
+#ifdef WORD_SCANNER_X86
+    case Implementation::SSE2:
+        classifySSE2(src, size, lowered, mask);
+        return;
+    case Implementation::AVX2:
+        classifyAVX2(src, size, lowered, mask);
+        return;
+#endif
+    default:
+        classifyScalar(src, 0, size, lowered, mask);
+        return;
+    }
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Unicode.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Поиск слов в буфере. В кодировке Ascii слово - непрерывная
+// последовательность ASCII букв и цифр (как std::isalnum в локали "C"),
+// все остальные байты - разделители. В кодировке Utf8 вход декодируется,
+// и словом считаются буквы и цифры Unicode (см. Unicode.h).
+// Буфер обрабатывается блоками: для блока сразу вычисляется битовая маска
+// "буква или цифра" и копия в нижнем регистре. На x86 это делается
+// векторными инструкциями SSE2/AVX2, выбор реализации - во время выполнения.
+// В режиме Utf8 так же обрабатываются блоки без байтов вне ASCII, а
+// декодирование включается только для блоков, где такие байты есть.
+class WordScanner {
+public:
+    enum class Implementation {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    enum class Encoding {
+        Ascii,
+        Utf8
+    };
+
+    // Размер блока, который классифицируется за один вызов
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    // Лучшая реализация, поддерживаемая процессором
+    static Implementation best();
+
+    // Поддерживает ли процессор данную реализацию
+    static bool isSupported(Implementation impl);
+
+    // Классифицировать size байтов (size <= CHUNK_SIZE): записать их в lowered
+    // в нижнем регистре и выставить в mask биты для букв и цифр.
+    // Биты маски за пределами size обнуляются
+    static void classify(
+        Implementation impl,
+        const char* src,
+        size_t size,
+        char* lowered,
+        uint64_t* mask
+    );
+
+    // Можно ли разрезать буфер перед этим байтом, не разрезав слово:
+    // ASCII символ, не являющийся буквой или цифрой
+    static bool isBoundary(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        bool digit = u >= '0' && u <= '9';
+        bool letter = (u | 0x20) >= 'a' && (u | 0x20) <= 'z';
+        return u < 0x80 && !digit && !letter;
+    }
+
+    // Содержит ли буфер только ASCII символы
+    static bool isAscii(const char* data, size_t size);
+
+    // Вызвать onWord(std::string_view) для каждого слова буфера в нижнем
+    // регистре. View действителен только во время вызова onWord
+    template <class Visitor>
+    static void scan(
+        const char* data,
+        size_t size,
+        Visitor&& onWord,
+        Encoding encoding = Encoding::Ascii,
+        Implementation impl = best()
+    );
+
+private:
+    // Разобрать блок по маске classify. pending - начало слова из
+    // предыдущего блока; незаконченное в конце блока слово остается в нем
+    template <class Visitor>
+    static void scanClassifiedChunk(
+        const char* lowered,
+        const uint64_t* mask,
+        size_t size,
+        bool lastChunk,
+        std::string& pending,
+        Visitor& onWord
+    );
+
+    // Разобрать блок с байтами вне ASCII, декодируя UTF-8. Слова собираются
+    // в pending, незаконченное в конце блока слово остается в нем
+    template <class Visitor>
+    static void scanUtf8Chunk(const char* src, size_t size, std::string& pending, Visitor& onWord);
+
+    static size_t countTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return index;
+#else
+        return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    // Позиция первого бита со значением bit в диапазоне [from, limit) или limit
+    static size_t findBit(const uint64_t* mask, size_t from, size_t limit, bool bit) {
+        while (from < limit) {
+            size_t index = from / 64;
+            uint64_t bits = bit ? mask[index] : ~mask[index];
+            bits &= ~0ULL << (from % 64);
+            if (bits != 0) {
+                return std::min(limit, index * 64 + countTrailingZeros(bits));
+            }
+            from = (index + 1) * 64;
+        }
+        return limit;
+    }
+};
+
+template <class Visitor>
+void WordScanner::scan(
+    const char* data,
+    size_t size,
+    Visitor&& onWord,
+    Encoding encoding,
+    Implementation impl
+) {
+    char lowered[CHUNK_SIZE];
+    uint64_t mask[CHUNK_SIZE / 64];
+    // Начало слова, не закончившегося в предыдущем блоке
+    std::string pending;
+
+    size_t offset = 0;
+    while (offset < size) {
+        size_t n = std::min(CHUNK_SIZE, size - offset);
+
+        if (encoding == Encoding::Utf8) {
+            // Не разрываем многобайтовую последовательность между блоками
+            size_t back = 0;
+            while (offset + n < size && back < 3 &&
+                   (static_cast<unsigned char>(data[offset + n]) & 0xC0) == 0x80) {
+                --n;
+                ++back;
+            }
+        }
+        bool lastChunk = offset + n == size;
+
+        if (encoding == Encoding::Ascii || isAscii(data + offset, n)) {
+            classify(impl, data + offset, n, lowered, mask);
+            scanClassifiedChunk(lowered, mask, n, lastChunk, pending, onWord);
+        } else {
+            scanUtf8Chunk(data + offset, n, pending, onWord);
+        }
+        offset += n;
+    }
+
+    if (!pending.empty()) {
+        onWord(std::string_view(pending));
+    }
+}
+
+template <class Visitor>
+void WordScanner::scanClassifiedChunk(
+    const char* lowered,
+    const uint64_t* mask,
+    size_t size,
+    bool lastChunk,
+    std::string& pending,
+    Visitor& onWord
+) {
+    size_t pos = 0;
+    if (!pending.empty()) {
+        size_t end = findBit(mask, 0, size, false);
+        pending.append(lowered, end);
+        if (end == size) {
+            return;
+        }
+        onWord(std::string_view(pending));
+        pending.clear();
+        pos = end;
+    }
+
+    while (true) {
+        size_t start = findBit(mask, pos, size, true);
+        if (start == size) {
+            break;
+        }
+        size_t end = findBit(mask, start, size, false);
+        if (end == size && !lastChunk) {
+            pending.assign(lowered + start, end - start);
+            break;
+        }
+        onWord(std::string_view(lowered + start, end - start));
+        pos = end;
+    }
+}
+
+template <class Visitor>
+void WordScanner::scanUtf8Chunk(const char* src, size_t size, std::string& pending, Visitor& onWord) {
+    size_t i = 0;
+    while (i < size) {
+        unsigned char c = static_cast<unsigned char>(src[i]);
+
+        // ASCII символы разбираются без декодирования
+        if (c < 0x80) {
+            if (!isBoundary(static_cast<char>(c))) {
+                pending += static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+            } else if (!pending.empty()) {
+                onWord(std::string_view(pending));
+                pending.clear();
+            }
+            ++i;
+            continue;
+        }
+
+        char32_t codePoint;
+        char32_t lower;
+        i += Unicode::decode(src + i, size - i, codePoint);
+        Unicode::CharClass charClass = Unicode::classify(codePoint, lower);
+        if (charClass == Unicode::CharClass::Mark) {
+            // Комбинируемый знак относится к предыдущей букве; без нее пропускается
+            if (!pending.empty()) {
+                char encoded[4];
+                pending.append(encoded, Unicode::encode(codePoint, encoded));
+            }
+        } else if (charClass != Unicode::CharClass::Other) {
+            char encoded[4];
+            pending.append(encoded, Unicode::encode(lower, encoded));
+        } else if (!pending.empty()) {
+            onWord(std::string_view(pending));
+            pending.clear();
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+// Таблица "слово -> частота", на которой построен WordCounter.
+// Реализации отличаются только способом хранения.
+class WordTable {
+public:
+    virtual ~WordTable() = default;
+
+    // Увеличить частоту слова на count (слово добавляется, если его не было)
+    virtual void add(std::string_view word, uint64_t count) = 0;
+
+    // Частота слова или 0, если его нет в таблице
+    virtual uint64_t find(std::string_view word) const = 0;
+
+    // Количество различных слов
+    virtual size_t size() const = 0;
+
+    // Сколько байтов занимает таблица (ячейки, узлы и байты слов)
+    virtual size_t memoryUsage() const = 0;
+
+    // Обойти все пары "слово - частота" (порядок обхода зависит от реализации)
+    virtual void forEach(const std::function<void(std::string_view, uint64_t)>& visitor) const = 0;
+
+    // Обходит ли forEach слова в алфавитном порядке
+    virtual bool isOrdered() const { return false; }
+};
@@ -0,0 +1,243 @@
+#include "AsyncReader.h"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../core/WordScanner.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Источник байтов для фонового потока
+class Source {
+private:
+    std::string filename;
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file;
+    std::FILE* stream;
+#ifndef _WIN32
+    int fd;
+    off_t offset;
+#endif
+
+public:
+    explicit Source(const std::string& fname) : filename(fname), file(nullptr, &std::fclose), stream(nullptr) {
+#ifndef _WIN32
+        fd = -1;
+        offset = 0;
+#endif
+        if (filename == "-") {
+#ifdef _WIN32
+            _setmode(_fileno(stdin), _O_BINARY);
+#endif
+            stream = stdin;
+            return;
+        }
+#ifndef _WIN32
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+#ifdef POSIX_FADV_SEQUENTIAL
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#else
+        file.reset(std::fopen(filename.c_str(), "rb"));
+        if (!file) {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+        stream = file.get();
+#endif
+    }
+
+    ~Source() {
+#ifndef _WIN32
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+    }
+
+    Source(const Source&) = delete;
+    Source& operator=(const Source&) = delete;
+
+    // Заполнить буфер целиком (меньше - только в конце входа)
+    size_t read(char* data, size_t size) {
+        size_t total = 0;
+        while (total < size) {
+            size_t n = 0;
+            if (stream != nullptr) {
+                n = std::fread(data + total, 1, size - total, stream);
+                if (n == 0 && std::ferror(stream)) {
+                    throw std::runtime_error("Cannot read file: " + filename);
+                }
+            }
+#ifndef _WIN32
+            else {
+                ssize_t got = ::pread(fd, data + total, size - total, offset);
+                if (got < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error("Cannot read file: " + filename);
+                }
+                n = static_cast<size_t>(got);
+                offset += got;
+            }
+#endif
+            if (n == 0) {
+                break;
+            }
+            total += n;
+        }
+        return total;
+    }
+};
+
+// Буфер, переходящий между фоновым потоком и потребителем
+struct Buffer {
+    std::vector<char> data;
+    size_t size = 0;
+};
+
+}
+
+AsyncReader::AsyncReader(const std::string& fname, size_t chunk, size_t buffers)
+    : filename(fname),
+      chunkSize(chunk == 0 ? DEFAULT_CHUNK_SIZE : chunk),
+      bufferCount(buffers < 2 ? 2 : buffers) {}
+
+void AsyncReader::readChunks(const std::function<void(const char*, size_t)>& onChunk) const {
+    // Файл открываем здесь, чтобы ошибка открытия пришла из вызывающего потока
+    Source source(filename);
+
+    std::vector<Buffer> buffers(bufferCount);
+    for (auto& buffer : buffers) {
+        buffer.data.resize(chunkSize);
+    }
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<Buffer*> freeBuffers;
+    std::deque<Buffer*> filledBuffers;
+    for (auto& buffer : buffers) {
+        freeBuffers.push_back(&buffer);
+    }
+    bool finished = false;  // Фоновый поток дочитал вход (или упал)
+    bool stopped = false;   // Потребитель больше не ждет данных
+    std::exception_ptr readError;
+
+    std::thread reader([&]() {
+        try {
+            while (true) {
+                Buffer* buffer = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&]() { return stopped || !freeBuffers.empty(); });
+                    if (stopped) {
+                        break;
+                    }
+                    buffer = freeBuffers.front();
+                    freeBuffers.pop_front();
+                }
+
+                buffer->size = source.read(buffer->data.data(), buffer->data.size());
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (buffer->size == 0) {
+                    break;
+                }
+                filledBuffers.push_back(buffer);
+                changed.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            readError = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        changed.notify_all();
+    });
+
+    // Слово, начатое в предыдущем буфере
+    std::string pending;
+    std::exception_ptr consumeError;
+    try {
+        while (true) {
+            Buffer* buffer = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return finished || !filledBuffers.empty(); });
+                if (filledBuffers.empty()) {
+                    break;
+                }
+                buffer = filledBuffers.front();
+                filledBuffers.pop_front();
+            }
+
+            const char* data = buffer->data.data();
+            size_t size = buffer->size;
+
+            // Начало буфера дописывает слово с прошлого стыка
+            size_t head = 0;
+            if (!pending.empty()) {
+                while (head < size && !WordScanner::isBoundary(data[head])) {
+                    ++head;
+                }
+                if (head < size) {
+                    ++head;
+                }
+                pending.append(data, head);
+                if (head < size) {
+                    onChunk(pending.data(), pending.size());
+                    pending.clear();
+                }
+            }
+
+            // Середина отдается без копирования, хвост после последнего разделителя ждет следующий буфер
+            size_t cut = size;
+            while (cut > head && !WordScanner::isBoundary(data[cut - 1])) {
+                --cut;
+            }
+            if (cut > head) {
+                onChunk(data + head, cut - head);
+            }
+            pending.append(data + cut, size - cut);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            freeBuffers.push_back(buffer);
+            changed.notify_all();
+        }
+        if (!pending.empty()) {
+            onChunk(pending.data(), pending.size());
+        }
+    } catch (...) {
+        consumeError = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+        changed.notify_all();
+    }
+    reader.join();
+
+    if (consumeError) {
+        std::rethrow_exception(consumeError);
+    }
+    if (readError) {
+        std::rethrow_exception(readError);
+    }
+}
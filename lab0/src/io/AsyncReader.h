@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Чтение входа с опережением: фоновый поток заполняет следующие буферы,
+// пока вызывающий поток разбирает текущий, поэтому ожидание диска и подсчет
+// слов идут одновременно. Файл читается через pread (на POSIX), стандартный
+// ввод и файлы на Windows - через fread.
+//
+// Как и у StreamReader, каждый переданный блок заканчивается на разделителе.
+// Блоки отдаются прямо из буферов чтения; копируется только слово, которое
+// попало на стык двух буферов.
+class AsyncReader {
+private:
+    std::string filename;
+    size_t chunkSize;
+    size_t bufferCount;
+
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+    static constexpr size_t DEFAULT_BUFFER_COUNT = 3;
+
+    explicit AsyncReader(
+        const std::string& fname,
+        size_t chunk = DEFAULT_CHUNK_SIZE,
+        size_t buffers = DEFAULT_BUFFER_COUNT
+    );
+
+    // Прочитать вход до конца, передавая каждый блок в onChunk(data, size).
+    // Ошибка чтения или исключение из onChunk останавливает фоновый поток
+    void readChunks(const std::function<void(const char*, size_t)>& onChunk) const;
+
+    // Читается ли стандартный ввод
+    bool isStdin() const { return filename == "-"; }
+};
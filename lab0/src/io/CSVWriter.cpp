@@ -1,33 +1,113 @@
 #include "CSVWriter.h"
-#include <fstream>
-#include <iomanip>
-#include <sstream>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
 
-CSVWriter::CSVWriter(const std::string& fname) : filename(fname) {}
+namespace {
 
-void CSVWriter::writeWordFrequency(
-    const std::vector<std::pair<std::string, int>>& words,
-    int totalWords
-) {
+// Запас в буфере под числовые поля одной строки
+constexpr size_t NUMBERS_RESERVE = 128;
+
+}
+
+CSVWriter::CSVWriter(const std::string& fname) : filename(fname), used(0) {}
+
+void CSVWriter::flush(std::ofstream& file) {
+    if (used > 0) {
+        file.write(buffer.data(), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+}
+
+void CSVWriter::append(std::ofstream& file, std::string_view text) {
+    if (used + text.size() > buffer.size()) {
+        flush(file);
+        // Строка длиннее всего буфера пишется напрямую
+        if (text.size() > buffer.size()) {
+            file.write(text.data(), static_cast<std::streamsize>(text.size()));
+            return;
+        }
+    }
+    std::memcpy(buffer.data() + used, text.data(), text.size());
+    used += text.size();
+}
+
+std::ofstream CSVWriter::open() {
     std::ofstream file(filename);
 
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open file for writing: " + filename);
     }
 
+    buffer.resize(BUFFER_SIZE);
+    used = 0;
+    return file;
+}
+
+void CSVWriter::close(std::ofstream& file) {
+    flush(file);
+    file.close();
+
+    if (file.fail()) {
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+}
+
+void CSVWriter::appendRow(std::ofstream& file, std::string_view key, uint64_t count, uint64_t total) {
+    append(file, key);
+
+    if (used + NUMBERS_RESERVE > buffer.size()) {
+        flush(file);
+    }
+
+    // Числа форматируются std::to_chars: результат тот же, что у
+    // std::fixed << std::setprecision(2), но без потоков и локалей
+    double percentage = (total > 0) ? (100.0 * count / total) : 0.0;
+
+    char* out = buffer.data() + used;
+    char* end = buffer.data() + buffer.size();
+    *out++ = ',';
+    out = std::to_chars(out, end, count).ptr;
+    *out++ = ',';
+    out = std::to_chars(out, end, percentage, std::chars_format::fixed, 2).ptr;
+    *out++ = '\n';
+    used = static_cast<size_t>(out - buffer.data());
+}
+
+void CSVWriter::writeWordFrequency(
+    const std::vector<std::pair<std::string_view, uint64_t>>& words,
+    uint64_t totalWords
+) {
+    std::ofstream file = open();
+
     // Пишем заголовок
-    file << "Слово,Частота,Частота (%)" << std::endl;
+    append(file, "Слово,Частота,Частота (%)\n");
 
     // Пишем данные (вектор уже отсортирован по убыванию частоты)
     for (const auto& pair : words) {
-        std::string word = pair.first;
-        int frequency = pair.second;
-        double percentage = (totalWords > 0) ? (100.0 * frequency / totalWords) : 0.0;
-
-        file << word << "," << frequency << ",";
-        file << std::fixed << std::setprecision(2) << percentage << std::endl;
+        appendRow(file, pair.first, pair.second, totalWords);
     }
 
-    file.close();
+    close(file);
 }
 
+void CSVWriter::writeHistogram(
+    std::string_view keyHeader,
+    const std::vector<std::pair<std::string, uint64_t>>& rows
+) {
+    std::ofstream file = open();
+
+    uint64_t total = 0;
+    for (const auto& row : rows) {
+        total += row.second;
+    }
+
+    append(file, keyHeader);
+    append(file, ",Количество,Доля (%)\n");
+
+    for (const auto& row : rows) {
+        appendRow(file, row.first, row.second, total);
+    }
+
+    close(file);
+}
@@ -1,21 +1,50 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 
 class CSVWriter {
 private:
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
     std::string filename;
+    // Строки формируются в буфере и записываются в файл крупными порциями
+    std::vector<char> buffer;
+    size_t used;
+
+    // Записать накопленный буфер в файл
+    void flush(std::ofstream& file);
+
+    // Добавить байты в буфер, сбрасывая его при заполнении
+    void append(std::ofstream& file, std::string_view text);
+
+    // Открыть файл и подготовить буфер
+    std::ofstream open();
+
+    // Сбросить буфер, закрыть файл и проверить, что запись удалась
+    void close(std::ofstream& file);
+
+    // Добавить строку "ключ,количество,доля от total в процентах"
+    void appendRow(std::ofstream& file, std::string_view key, uint64_t count, uint64_t total);
 
 public:
     explicit CSVWriter(const std::string& fname);
 
     // Написать CSV файл со словами и частотами
     void writeWordFrequency(
-        const std::vector<std::pair<std::string, int>>& words,
-        int totalWords
+        const std::vector<std::pair<std::string_view, uint64_t>>& words,
+        uint64_t totalWords
     );
-};
-
 
+    // Написать CSV файл с гистограммой: подпись интервала, количество и доля
+    // от суммы всех интервалов. keyHeader - заголовок первого столбца
+    void writeHistogram(
+        std::string_view keyHeader,
+        const std::vector<std::pair<std::string, uint64_t>>& rows
+    );
+};
@@ -1,10 +1,13 @@
 #include "FileReader.h"
+#include <algorithm>
 #include <fstream>
+#include <filesystem>
 #include <sstream>
+#include <system_error>
 
 FileReader::FileReader(const std::string& fname) : filename(fname) {}
 
-std::vector<std::string> FileReader::readLines() const {
+std::vector<std::string> FileReader::readLines(bool* lastLineTerminated) const {
     std::vector<std::string> lines;
     std::ifstream file(filename);
 
@@ -13,8 +16,14 @@ std::vector<std::string> FileReader::readLines() const {
     }
 
     std::string line;
+    bool terminated = true;
     while (std::getline(file, line)) {
         lines.push_back(line);
+        // getline дошел до конца файла, не встретив перевода строки
+        terminated = !file.eof();
+    }
+    if (lastLineTerminated != nullptr) {
+        *lastLineTerminated = terminated;
     }
 
     file.close();
@@ -22,7 +31,32 @@ std::vector<std::string> FileReader::readLines() const {
 }
 
 bool FileReader::fileExists() const {
-    std::ifstream file(filename);
-    return file.good();
+    // Проверяем по метаданным, не открывая файл
+    std::error_code error;
+    return std::filesystem::is_regular_file(filename, error);
 }
 
+std::vector<std::string> FileReader::listFiles(const std::vector<std::string>& paths) {
+    std::vector<std::string> files;
+    for (const auto& path : paths) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(path, error)) {
+            files.push_back(path);
+            continue;
+        }
+
+        std::vector<std::string> found;
+        std::filesystem::recursive_directory_iterator it(path, error);
+        if (error) {
+            throw std::runtime_error("Cannot read directory: " + path);
+        }
+        for (const auto& entry : it) {
+            if (entry.is_regular_file(error)) {
+                found.push_back(entry.path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+}
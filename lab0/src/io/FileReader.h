@@ -10,11 +10,16 @@ private:
 public:
     explicit FileReader(const std::string& fname);
 
-    // Прочитать весь файл и вернуть строки
-    std::vector<std::string> readLines() const;
+    // Прочитать весь файл и вернуть строки. В lastLineTerminated, если он
+    // передан, записывается, завершалась ли последняя строка переводом строки
+    std::vector<std::string> readLines(bool* lastLineTerminated = nullptr) const;
 
     // Проверить существование файла
     bool fileExists() const;
+
+    // Развернуть список путей в список файлов: каталоги обходятся
+    // рекурсивно, их файлы идут в алфавитном порядке
+    static std::vector<std::string> listFiles(const std::vector<std::string>& paths);
 };
 
 
@@ -0,0 +1,162 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& fname)
+    : filename(fname), data_(nullptr), size_(0),
+      fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {
+    fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    // У каналов и устройств нет размера, и отобразить их нельзя
+    if (GetFileType(fileHandle) != FILE_TYPE_DISK) {
+        unmap();
+        throw std::runtime_error("Cannot map a non-regular file (read it with --stream): " + filename);
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        unmap();
+        throw std::runtime_error("Cannot get size of file: " + filename);
+    }
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+
+    // Пустой файл отобразить нельзя, но и читать в нем нечего
+    if (size_ == 0) {
+        return;
+    }
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        unmap();
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+
+    data_ = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        unmap();
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+}
+
+void MappedFile::unmap() {
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mappingHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : filename(std::move(other.filename)), data_(other.data_), size_(other.size_),
+      fileHandle(other.fileHandle), mappingHandle(other.mappingHandle) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.fileHandle = INVALID_HANDLE_VALUE;
+    other.mappingHandle = nullptr;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        filename = std::move(other.filename);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+    }
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& fname)
+    : filename(fname), data_(nullptr), size_(0) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot get size of file: " + filename);
+    }
+    // У каналов и устройств st_size не равен длине данных, и отобразить их нельзя
+    if (!S_ISREG(st.st_mode)) {
+        ::close(fd);
+        throw std::runtime_error("Cannot map a non-regular file (read it with --stream): " + filename);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    // Пустой файл отобразить нельзя, но и читать в нем нечего
+    if (size_ == 0) {
+        ::close(fd);
+        return;
+    }
+
+    void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    // Дескриптор после mmap больше не нужен: отображение держит файл само
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        size_ = 0;
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+
+    // Файл читается один раз от начала до конца
+    ::madvise(mapped, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(mapped);
+}
+
+void MappedFile::unmap() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : filename(std::move(other.filename)), data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        filename = std::move(other.filename);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    unmap();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Файл, отображенный в память только для чтения.
+// Данные доступны напрямую, без копирования в буферы программы.
+class MappedFile {
+private:
+    std::string filename;
+    const char* data_;
+    size_t size_;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    void unmap();
+
+public:
+    explicit MappedFile(const std::string& fname);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Указатель на начало отображенных данных (nullptr для пустого файла)
+    const char* data() const { return data_; }
+
+    // Размер файла в байтах
+    size_t size() const { return size_; }
+};
@@ -0,0 +1,69 @@
+#include "StreamReader.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "../core/WordScanner.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+StreamReader::StreamReader(const std::string& fname, size_t chunk)
+    : filename(fname), chunkSize(chunk == 0 ? DEFAULT_CHUNK_SIZE : chunk) {}
+
+void StreamReader::readChunks(const std::function<void(const char*, size_t)>& onChunk) const {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> owned(nullptr, &std::fclose);
+    std::FILE* input = stdin;
+
+    if (isStdin()) {
+#ifdef _WIN32
+        // Без этого Windows преобразует переводы строк и останавливается на Ctrl+Z
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    } else {
+        owned.reset(std::fopen(filename.c_str(), "rb"));
+        if (!owned) {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+        input = owned.get();
+    }
+
+    std::vector<char> buffer(chunkSize);
+    // Сколько байтов в начале буфера осталось от предыдущего блока
+    size_t carried = 0;
+
+    while (true) {
+        if (carried == buffer.size()) {
+            // Слово длиннее блока: приходится расширять буфер
+            buffer.resize(buffer.size() * 2);
+        }
+
+        size_t read = std::fread(buffer.data() + carried, 1, buffer.size() - carried, input);
+        if (read == 0) {
+            if (std::ferror(input)) {
+                throw std::runtime_error("Cannot read file: " + filename);
+            }
+            break;
+        }
+
+        size_t filled = carried + read;
+        // Режем по последнему разделителю, остаток переносим в следующий блок
+        size_t cut = filled;
+        while (cut > 0 && !WordScanner::isBoundary(buffer[cut - 1])) {
+            --cut;
+        }
+
+        if (cut > 0) {
+            onChunk(buffer.data(), cut);
+            std::memmove(buffer.data(), buffer.data() + cut, filled - cut);
+        }
+        carried = filled - cut;
+    }
+
+    if (carried > 0) {
+        onChunk(buffer.data(), carried);
+    }
+}
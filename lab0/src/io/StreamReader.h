@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Потоковое чтение входа блоками фиксированного размера.
+// Имя "-" означает стандартный ввод, поэтому вход можно подать через конвейер.
+// Блок всегда обрывается на разделителе: хвост с недочитанным словом
+// переносится в начало следующего блока. Память ограничена размером блока
+// (буфер растет только если одно слово длиннее блока).
+class StreamReader {
+private:
+    std::string filename;
+    size_t chunkSize;
+
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+    explicit StreamReader(const std::string& fname, size_t chunk = DEFAULT_CHUNK_SIZE);
+
+    // Прочитать вход до конца, передавая каждый блок в onChunk(data, size)
+    void readChunks(const std::function<void(const char*, size_t)>& onChunk) const;
+
+    // Читается ли стандартный ввод
+    bool isStdin() const { return filename == "-"; }
+};
@@ -1,38 +1,282 @@
+#include <algorithm>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include "io/FileReader.h"
+#include "io/MappedFile.h"
+#include "io/AsyncReader.h"
+#include "io/StreamReader.h"
+#include "core/ApproximateCounter.h"
+#include "core/CorpusHistograms.h"
+#include "core/NGramCounter.h"
+#include "core/StopWords.h"
+#include "core/WordFilter.h"
 #include "core/WordCounter.h"
 #include "core/WordProcessor.h"
 #include "io/CSVWriter.h"
+#include "utils/CommandLineParser.h"
+#include "utils/PipelineStats.h"
+
+// Прочитать вход блоками: в режиме Async следующие блоки читаются заранее в фоновом потоке
+static void readBlocks(const ProgramOptions& options, const std::function<void(const char*, size_t)>& onChunk) {
+    if (options.inputMode == InputMode::Async) {
+        AsyncReader(options.inputFile).readChunks(onChunk);
+    } else {
+        StreamReader(options.inputFile).readChunks(onChunk);
+    }
+}
+
+// Сколько слов выводится в приближенном режиме, если --top не задан
+constexpr size_t DEFAULT_APPROX_TOP = 100;
+
+// Приближенный подсчет в фиксированной памяти: вход читается блоками или
+// отображается в память, в CSV попадают только самые частые слова
+static void runApproximate(const ProgramOptions& options, const WordFilter* filter, PipelineStats& stats) {
+    ApproximateCounter counter(options.approxMemory);
+
+    stats.startStage("count");
+    uint64_t bytes = 0;
+    if (options.inputMode == InputMode::Stream || options.inputMode == InputMode::Async) {
+        readBlocks(options, [&counter, &options, filter, &bytes](const char* data, size_t size) {
+            WordProcessor::processBuffer(data, size, counter, options.encoding, filter);
+            bytes += size;
+        });
+    } else {
+        MappedFile file(options.inputFile);
+        WordProcessor::processBuffer(file.data(), file.size(), counter, options.encoding, filter);
+        bytes = file.size();
+    }
+    stats.finishStage(bytes, counter.getTotalWords(), counter.getTrackedWords(), counter.getMemoryUsage());
+
+    stats.startStage("sort");
+    std::vector<ApproximateCounter::Entry> top =
+        counter.getTopK(options.top > 0 ? options.top : DEFAULT_APPROX_TOP);
+    std::vector<WordCounter::Entry> sortedWords;
+    sortedWords.reserve(top.size());
+    uint64_t maxUncertainty = 0;
+    for (const auto& entry : top) {
+        sortedWords.emplace_back(entry.word, entry.estimate);
+        maxUncertainty = std::max(maxUncertainty, entry.estimate - entry.lowerBound);
+    }
+    stats.finishStage(0, 0, counter.getTrackedWords(), counter.getMemoryUsage());
+
+    stats.startStage("write");
+    CSVWriter writer(options.outputFile);
+    writer.writeWordFrequency(sortedWords, counter.getTotalWords());
+    stats.finishStage(0, 0, counter.getTrackedWords(), counter.getMemoryUsage());
+
+    std::cout << "Approximately processed " << counter.getTotalWords() << " words using "
+              << counter.getMemoryUsage() << " bytes." << std::endl;
+    std::cout << "Counts are upper bounds: each exceeds the true frequency by at most "
+              << counter.getErrorBound() << " (epsilon " << counter.getEpsilon()
+              << ") with probability " << 1.0 - counter.getDelta() << "." << std::endl;
+    std::cout << "Guaranteed lower bounds are within " << maxUncertainty
+              << " of the reported counts." << std::endl;
+    std::cout << "Results written to " << options.outputFile << std::endl;
+}
 
 int main(int argc, char* argv[]) {
-    // Проверяем количество аргументов
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <input.txt> <output.csv>" << std::endl;
+    // Разбираем аргументы командной строки
+    CommandLineParser parser(argc, argv);
+    ProgramOptions options;
+    try {
+        options = parser.parse();
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << parser.usage();
         return 1;
     }
 
-    std::string inputFile = argv[1];
-    std::string outputFile = argv[2];
-
     try {
-        // Читаем входной файл
-        FileReader reader(inputFile);
-        std::vector<std::string> lines = reader.readLines();
+        PipelineStats stats(options.stats || !options.statsJson.empty());
+
+        // Вывести замеры по стадиям, если они включены
+        auto reportStats = [&stats, &options]() {
+            if (options.stats) {
+                stats.writeText(std::cerr);
+            }
+            if (!options.statsJson.empty()) {
+                std::ofstream json(options.statsJson);
+                if (!json.is_open()) {
+                    throw std::runtime_error("Cannot open file for writing: " + options.statsJson);
+                }
+                stats.writeJson(json);
+            }
+        };
 
-        // Подсчитываем частоты слов
-        WordCounter counter;
-        WordProcessor::processLines(lines, counter);
+        // Фильтр стоп-слов и стеммер строятся один раз до чтения входа
+        std::unique_ptr<WordFilter> filter;
+        if (!options.stopWordsFile.empty() || options.stem) {
+            StopWords stopWords;
+            if (!options.stopWordsFile.empty()) {
+                stopWords = StopWords::fromFile(options.stopWordsFile, options.encoding);
+            }
+            filter = std::make_unique<WordFilter>(std::move(stopWords), options.stem);
+        }
 
-        // Получаем отсортированные слова
-        std::vector<std::pair<std::string, int>> sortedWords = counter.getSortedWords();
-        int totalWords = counter.getTotalWords();
+        if (options.approxMemory > 0) {
+            runApproximate(options, filter.get(), stats);
+            reportStats();
+            return 0;
+        }
+
+        WordCounter counter(options.backend);
+        std::unique_ptr<NGramCounter> ngrams;
+        if (options.ngrams > 0) {
+            ngrams = std::make_unique<NGramCounter>(options.ngrams);
+        }
+        std::unique_ptr<CorpusHistograms> histograms;
+        if (!options.histogramsPrefix.empty()) {
+            histograms = std::make_unique<CorpusHistograms>();
+        }
+        WordProcessor::Extras extras;
+        extras.filter = filter.get();
+        extras.ngrams = ngrams.get();
+        extras.histograms = histograms.get();
+
+        // Разобрать буфер, заодно выполняя включенные дополнительные подсчеты
+        auto countBuffer = [&counter, &extras, &options](const char* data, size_t size) {
+            if (extras.empty()) {
+                WordProcessor::processBuffer(data, size, counter, options.encoding);
+            } else {
+                WordProcessor::processBuffer(data, size, counter, extras, options.encoding);
+            }
+        };
+
+        // Завершить замер стадии; число слов считается только при включенной статистике
+        uint64_t wordsBefore = 0;
+        auto startStage = [&](const std::string& name) {
+            if (stats.enabled()) {
+                wordsBefore = counter.getTotalWords();
+                stats.startStage(name);
+            }
+        };
+        auto finishStage = [&](uint64_t bytes) {
+            if (stats.enabled()) {
+                uint64_t words = counter.getTotalWords() - wordsBefore;
+                stats.finishStage(bytes, words, counter.getDistinctWords(), counter.getMemoryUsage());
+            }
+        };
+
+        // Продолжаем подсчет с сохраненного снимка
+        if (!options.snapshotIn.empty()) {
+            startStage("snapshot-load");
+            counter.loadSnapshot(options.snapshotIn);
+            finishStage(0);
+        }
+
+        if (options.batch) {
+            // Пул потоков разбирает файлы по одному и сливает результаты
+            startStage("list");
+            std::vector<std::string> files = FileReader::listFiles(options.inputFiles);
+            finishStage(0);
+
+            startStage("read+count");
+            uint64_t bytes = WordProcessor::processFiles(files, counter, options.threads, options.encoding, filter.get());
+            finishStage(bytes);
+        } else if (options.threads > 1) {
+            // Делим отображенный файл на части и считаем их параллельно
+            startStage("map");
+            MappedFile file(options.inputFile);
+            finishStage(file.size());
+
+            startStage("count");
+            WordProcessor::processBufferParallel(
+                file.data(), file.size(), counter, options.threads, options.encoding, filter.get());
+            finishStage(file.size());
+        } else if (options.inputMode == InputMode::Stream || options.inputMode == InputMode::Async) {
+            // Читаем вход блоками и сразу разбираем каждый блок
+            startStage("read+count");
+            uint64_t bytes = 0;
+            readBlocks(options, [&countBuffer, &bytes](const char* data, size_t size) {
+                countBuffer(data, size);
+                bytes += size;
+            });
+            finishStage(bytes);
+        } else if (options.inputMode == InputMode::Mmap) {
+            // Разбираем слова прямо из отображенного в память файла
+            startStage("map");
+            MappedFile file(options.inputFile);
+            finishStage(file.size());
+
+            startStage("count");
+            countBuffer(file.data(), file.size());
+            finishStage(file.size());
+        } else {
+            // Читаем входной файл
+            startStage("read");
+            FileReader reader(options.inputFile);
+            bool lastLineTerminated = true;
+            std::vector<std::string> lines = reader.readLines(&lastLineTerminated);
+            uint64_t bytes = 0;
+            for (const auto& line : lines) {
+                bytes += line.size() + 1;
+            }
+            if (!lines.empty() && !lastLineTerminated) {
+                bytes--;
+            }
+            finishStage(bytes);
+
+            // Подсчитываем частоты слов
+            startStage("count");
+            if (!extras.empty()) {
+                WordProcessor::processLines(lines, counter, extras, options.encoding, lastLineTerminated);
+            } else {
+                WordProcessor::processLines(lines, counter, options.encoding);
+            }
+            finishStage(bytes);
+        }
+
+        if (!options.snapshotOut.empty()) {
+            startStage("snapshot-save");
+            counter.saveSnapshot(options.snapshotOut);
+            finishStage(0);
+        }
+
+        // Получаем отсортированные слова (или только самые частые)
+        startStage("sort");
+        std::vector<WordCounter::Entry> sortedWords =
+            options.top > 0 ? counter.getTopK(options.top) : counter.getSortedWords();
+        uint64_t totalWords = counter.getTotalWords();
+        finishStage(0);
 
         // Пишем результаты в CSV файл
-        CSVWriter writer(outputFile);
+        startStage("write");
+        CSVWriter writer(options.outputFile);
         writer.writeWordFrequency(sortedWords, totalWords);
+        finishStage(0);
+
+        // Гистограммы корпуса пишутся в три CSV файла с общим префиксом
+        if (histograms) {
+            startStage("histograms");
+            histograms->finish();
+            CSVWriter(options.histogramsPrefix + ".words.csv").writeHistogram("Длина слова", histograms->wordLengthRows());
+            CSVWriter(options.histogramsPrefix + ".bytes.csv").writeHistogram("Байт", histograms->byteRows());
+            CSVWriter(options.histogramsPrefix + ".lines.csv").writeHistogram("Длина строки", histograms->lineLengthRows());
+            finishStage(0);
+        }
+
+        // n-граммы пишутся в отдельный CSV в том же формате
+        if (ngrams) {
+            startStage(std::to_string(ngrams->getN()) + "-grams");
+            std::vector<WordCounter::Entry> sortedNGrams = ngrams->getSortedNGrams(options.top);
+            CSVWriter ngramWriter(options.ngramOutput);
+            ngramWriter.writeWordFrequency(sortedNGrams, ngrams->getTotalNGrams());
+            // В строке стадии - таблица n-грамм, а не счетчик слов
+            stats.finishStage(0, ngrams->getTotalNGrams(), ngrams->getDistinctNGrams(), ngrams->getMemoryUsage());
+        }
+
+        reportStats();
 
         std::cout << "Successfully processed " << totalWords << " words." << std::endl;
-        std::cout << "Results written to " << outputFile << std::endl;
+        std::cout << "Results written to " << options.outputFile << std::endl;
+        if (ngrams) {
+            std::cout << "N-grams written to " << options.ngramOutput << std::endl;
+        }
+        if (histograms) {
+            std::cout << "Histograms written to " << options.histogramsPrefix << ".{words,bytes,lines}.csv" << std::endl;
+        }
 
         return 0;
     } catch (const std::exception& e) {
@@ -40,4 +284,3 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 }
-
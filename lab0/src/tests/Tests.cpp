@@ -0,0 +1,925 @@
+#include "test_runner.h"
+#include "Tests.h"
+#include "../core/WordCounter.h"
+#include "../core/WordProcessor.h"
+#include "../core/WordScanner.h"
+#include "../core/StringArena.h"
+#include "../core/FlatWordTable.h"
+#include "../core/TreeWordTable.h"
+#include "../core/ApproximateCounter.h"
+#include "../core/SpaceSaving.h"
+#include "../core/NGramCounter.h"
+#include "../core/CorpusHistograms.h"
+#include "../core/StopWords.h"
+#include "../core/Stemmer.h"
+#include "../core/WordFilter.h"
+#include "../io/CSVWriter.h"
+#include "../io/FileReader.h"
+#include "../io/MappedFile.h"
+#include "../io/StreamReader.h"
+#include "../io/AsyncReader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Эталонное разбиение на слова: побайтовый std::isalnum и std::tolower
+std::vector<std::string> referenceWords(const std::string& text) {
+    std::vector<std::string> words;
+    std::string current;
+    for (char c : text) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (std::isalnum(u)) {
+            current += static_cast<char>(std::tolower(u));
+        } else if (!current.empty()) {
+            words.push_back(current);
+            current.clear();
+        }
+    }
+    if (!current.empty()) {
+        words.push_back(current);
+    }
+    return words;
+}
+
+std::vector<std::string> scanWords(const std::string& text, WordScanner::Implementation impl) {
+    std::vector<std::string> words;
+    WordScanner::scan(text.data(), text.size(), [&words](std::string_view word) {
+        words.emplace_back(word);
+    }, WordScanner::Encoding::Ascii, impl);
+    return words;
+}
+
+}
+
+void TestAssertThrows() {
+    // ASSERT_THROWS должен падать, если исключения нет или оно другого типа
+    auto fails = [](auto check) {
+        try {
+            check();
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+
+    ASSERT(fails([] { ASSERT_THROWS((void)0, std::runtime_error); }));
+    ASSERT(fails([] { ASSERT_THROWS(throw std::invalid_argument("x"), std::out_of_range); }));
+    ASSERT(!fails([] { ASSERT_THROWS(throw std::invalid_argument("x"), std::invalid_argument); }));
+    ASSERT(!fails([] { ASSERT_THROWS(throw std::invalid_argument("x"), std::logic_error); }));
+}
+
+void TestExtractWords() {
+    // Пустая строка и строка из одних разделителей
+    ASSERT_EQUAL(WordProcessor::extractWords("").size(), 0u);
+    ASSERT_EQUAL(WordProcessor::extractWords(" ,.!? ").size(), 0u);
+
+    // Регистр приводится к нижнему, цифры входят в слово
+    std::vector<std::string> expected = {"hello", "world", "a1b2", "42"};
+    ASSERT_EQUAL(WordProcessor::extractWords("Hello, WORLD! a1B2 (42)"), expected);
+
+    // Байты вне ASCII считаются разделителями
+    std::vector<std::string> split = {"ab", "cd"};
+    ASSERT_EQUAL(WordProcessor::extractWords("ab\xD0\x9F" "cd"), split);
+}
+
+void TestScannerImplementationsAgree() {
+    const WordScanner::Implementation implementations[] = {
+        WordScanner::Implementation::Scalar,
+        WordScanner::Implementation::SSE2,
+        WordScanner::Implementation::AVX2
+    };
+
+    std::mt19937 rng(12345);
+    const std::string alphabet = "abcXYZ019 \n\t.,-@[`{\x7f\x80\xD0\xFF";
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+
+    // Разные длины, в том числе кратные блоку и слова длиннее блока
+    const size_t sizes[] = {0, 1, 15, 16, 31, 32, 33, 63, 64, 65, 4095, 4096, 4097, 10000};
+    for (size_t size : sizes) {
+        std::string text;
+        for (size_t i = 0; i < size; ++i) {
+            text += alphabet[pick(rng)];
+        }
+        std::vector<std::string> expected = referenceWords(text);
+
+        for (auto impl : implementations) {
+            if (!WordScanner::isSupported(impl)) {
+                continue;
+            }
+            ASSERT_EQUAL(scanWords(text, impl), expected);
+        }
+    }
+
+    // Одно слово через несколько блоков
+    std::string longWord(3 * WordScanner::CHUNK_SIZE + 7, 'Q');
+    for (auto impl : implementations) {
+        if (WordScanner::isSupported(impl)) {
+            ASSERT_EQUAL(scanWords(" " + longWord + " x", impl), referenceWords(" " + longWord + " x"));
+        }
+    }
+}
+
+void TestTopK() {
+    const std::string text = "b a c a b a d e e e e c b x y z";
+    for (auto backend : {WordCounter::Backend::Tree, WordCounter::Backend::Hash}) {
+        WordCounter counter(backend);
+        WordProcessor::processBuffer(text.data(), text.size(), counter);
+        auto all = counter.getSortedWords();
+
+        // Первые k слов совпадают с началом полной сортировки, включая
+        // порядок слов с одинаковой частотой
+        for (size_t k = 0; k <= all.size() + 1; ++k) {
+            auto top = counter.getTopK(k);
+            ASSERT_EQUAL(top.size(), std::min(k, all.size()));
+            for (size_t i = 0; i < top.size(); ++i) {
+                ASSERT_EQUAL(top[i], all[i]);
+            }
+        }
+    }
+
+    WordCounter empty;
+    ASSERT_EQUAL(empty.getTopK(10).size(), 0u);
+}
+
+void TestCSVWriterFormat() {
+    // Вывод должен побайтно совпадать с форматированием через потоки
+    std::vector<std::string> storage;
+    const int totalWords = 7919;
+    for (int frequency = totalWords; frequency > 0; frequency -= 37) {
+        storage.push_back("w" + std::to_string(frequency));
+    }
+    storage.push_back(std::string(2 << 20, 'x'));
+
+    std::vector<std::pair<std::string_view, uint64_t>> words;
+    for (int frequency = totalWords; frequency > 0; frequency -= 37) {
+        words.emplace_back(storage[words.size()], frequency);
+    }
+    words.emplace_back(storage.back(), 1);
+
+    std::ostringstream expected;
+    expected << "Слово,Частота,Частота (%)" << std::endl;
+    for (const auto& pair : words) {
+        double percentage = 100.0 * pair.second / totalWords;
+        expected << pair.first << "," << pair.second << ",";
+        expected << std::fixed << std::setprecision(2) << percentage << std::endl;
+    }
+
+    const std::string filename = "test_csv_writer_format.csv";
+    CSVWriter writer(filename);
+    writer.writeWordFrequency(words, totalWords);
+
+    std::ifstream in(filename, std::ios::binary);
+    std::ostringstream actual;
+    actual << in.rdbuf();
+    in.close();
+    std::remove(filename.c_str());
+
+    ASSERT(actual.str() == expected.str());
+}
+
+void TestStreamReaderChunks() {
+    // Маленький блок, чтобы слова гарантированно попадали на границы блоков
+    std::string text = "Alpha beta,gamma\nDELTA " + std::string(50, 'z') + " epsilon 123";
+    const std::string filename = "test_stream_reader.txt";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out << text;
+    }
+
+    for (size_t chunk : {1u, 3u, 7u, 16u, 1024u}) {
+        std::vector<std::string> words;
+        StreamReader reader(filename, chunk);
+        reader.readChunks([&words](const char* data, size_t size) {
+            // Каждый блок, кроме последнего, заканчивается разделителем
+            std::string block(data, size);
+            for (const auto& word : WordProcessor::extractWords(block)) {
+                words.push_back(word);
+            }
+        });
+        ASSERT_EQUAL(words, referenceWords(text));
+    }
+
+    std::remove(filename.c_str());
+    ASSERT_THROWS(StreamReader("non_existent.txt").readChunks([](const char*, size_t) {}),
+                  std::runtime_error);
+}
+
+void TestMappedFile() {
+    const std::string filename = "test_mapped_file.txt";
+    const std::string text = "mapped words\n";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out << text;
+    }
+    {
+        MappedFile file(filename);
+        ASSERT_EQUAL(std::string(file.data(), file.size()), text);
+    }
+
+    // Пустой файл отображается без данных
+    {
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    }
+    {
+        MappedFile file(filename);
+        ASSERT_EQUAL(file.size(), 0u);
+    }
+    std::remove(filename.c_str());
+
+    // Устройство (как и канал) не принимается за пустой файл
+#ifdef _WIN32
+    ASSERT_THROWS(MappedFile("NUL"), std::runtime_error);
+#else
+    ASSERT_THROWS(MappedFile("/dev/null"), std::runtime_error);
+#endif
+    ASSERT_THROWS(MappedFile("non_existent.txt"), std::runtime_error);
+}
+
+void TestSnapshotRoundTrip() {
+    const std::string first = "one two two three three three";
+    const std::string second = "three four";
+    const std::string filename = "test_snapshot.bin";
+
+    // Эталон: оба текста посчитаны за один раз
+    WordCounter expected;
+    WordProcessor::processBuffer(first.data(), first.size(), expected);
+    WordProcessor::processBuffer(second.data(), second.size(), expected);
+
+    const auto backends = {WordCounter::Backend::Tree, WordCounter::Backend::Hash, WordCounter::Backend::Compact};
+    for (auto saveBackend : backends) {
+        WordCounter saved(saveBackend);
+        WordProcessor::processBuffer(first.data(), first.size(), saved);
+        saved.saveSnapshot(filename);
+
+        for (auto loadBackend : backends) {
+            WordCounter loaded(loadBackend);
+            loaded.loadSnapshot(filename);
+            ASSERT_EQUAL(loaded.getSortedWords(), saved.getSortedWords());
+            ASSERT_EQUAL(loaded.getTotalWords(), saved.getTotalWords());
+
+            // Новые слова добавляются к загруженным
+            WordProcessor::processBuffer(second.data(), second.size(), loaded);
+            ASSERT_EQUAL(loaded.getSortedWords(), expected.getSortedWords());
+            ASSERT_EQUAL(loaded.getFrequency("three"), 4u);
+        }
+    }
+
+    // Снимок загружается, дополняется и сохраняется в тот же файл
+    for (auto backend : backends) {
+        WordCounter saved(backend);
+        WordProcessor::processBuffer(first.data(), first.size(), saved);
+        saved.saveSnapshot(filename);
+
+        WordCounter updated(backend);
+        updated.loadSnapshot(filename);
+        WordProcessor::processBuffer(second.data(), second.size(), updated);
+        updated.saveSnapshot(filename);
+        ASSERT_EQUAL(updated.getSortedWords(), expected.getSortedWords());
+
+        WordCounter reloaded(backend);
+        reloaded.loadSnapshot(filename);
+        ASSERT_EQUAL(reloaded.getSortedWords(), expected.getSortedWords());
+        ASSERT_EQUAL(reloaded.getTotalWords(), expected.getTotalWords());
+    }
+    std::remove(filename.c_str());
+
+    // Не снимок
+    const std::string bad = "test_snapshot_bad.bin";
+    {
+        std::ofstream out(bad, std::ios::binary);
+        out << "definitely not a snapshot, but long enough to hold a header";
+    }
+    WordCounter counter(WordCounter::Backend::Hash);
+    ASSERT_THROWS(counter.loadSnapshot(bad), std::runtime_error);
+    std::remove(bad.c_str());
+
+    // Нет файла
+    ASSERT_THROWS(counter.loadSnapshot("non_existent_snapshot.bin"), std::runtime_error);
+    ASSERT_EQUAL(counter.getTotalWords(), 0u);
+}
+
+void TestUtf8Words() {
+    using Encoding = WordScanner::Encoding;
+
+    // Кириллица, греческий, латиница с диакритикой; регистр приводится
+    std::vector<std::string> expected = {
+        "привет", "мир", "ёлка", "straße", "σοφια", "çà", "123", "x2"
+    };
+    ASSERT_EQUAL(WordProcessor::extractWords("Привет, МИР! Ёлка—Straße ΣΟΦΙΑ «ÇÀ» 123 x2", Encoding::Utf8),
+                 expected);
+
+    // Комбинируемые знаки продолжают слово: деванагари, иврит, арабский, NFD
+    std::vector<std::string> marks = {
+        "हिन्दी", "भाषा", "שָׁלוֹם", "مَرْحَبًا", "cafe\u0301", "x"
+    };
+    ASSERT_EQUAL(WordProcessor::extractWords(
+                     "हिन्दी भाषा, שָׁלוֹם مَرْحَبًا CAFE\u0301 \u0301x", Encoding::Utf8),
+                 marks);
+
+    // Регистр Latin Extended-B и греческого
+    std::vector<std::string> folded = {"ǆ", "ǆ", "ǆ", "ɓ", "ǝ", "ϙ", "ϸ", "ͻ"};
+    ASSERT_EQUAL(WordProcessor::extractWords("Ǆ ǅ ǆ Ɓ Ǝ Ϙ Ϸ Ͻ", Encoding::Utf8), folded);
+
+    // Турецкая İ, заглавная ẞ, грузинские мтаврули и асомтаврули
+    std::vector<std::string> special = {"istanbul", "istanbul", "straße", "straße", "საქართველო", "ⴀⴁ"};
+    ASSERT_EQUAL(WordProcessor::extractWords("İstanbul istanbul STRAẞE straße ᲡᲐᲥᲐᲠᲗᲕᲔᲚᲝ ႠႡ", Encoding::Utf8),
+                 special);
+
+    // Некорректные последовательности считаются разделителями
+    std::vector<std::string> invalid = {"ab", "cd", "ef"};
+    ASSERT_EQUAL(WordProcessor::extractWords("ab\xFF" "cd\xD0" "ef", Encoding::Utf8), invalid);
+
+    // На чистом ASCII результат совпадает с режимом Ascii
+    std::mt19937 rng(777);
+    std::string ascii;
+    for (int i = 0; i < 20000; ++i) {
+        ascii += static_cast<char>(rng() % 128);
+    }
+    ASSERT_EQUAL(WordProcessor::extractWords(ascii, Encoding::Utf8), referenceWords(ascii));
+
+    // Слова и многобайтовые символы на границах блоков сканера
+    std::string text;
+    std::vector<std::string> words;
+    for (int i = 0; i < 3000; ++i) {
+        text += i % 3 == 0 ? "Дом " : i % 3 == 1 ? "abcЖ, " : "ЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁЁ\n";
+        words.push_back(i % 3 == 0 ? "дом" : i % 3 == 1 ? "abcж" : "ёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёёё");
+    }
+    ASSERT_EQUAL(WordProcessor::extractWords(text, Encoding::Utf8), words);
+}
+
+void TestStringArena() {
+    StringArena arena;
+
+    // Строки копируются и остаются на месте при последующих выделениях
+    std::vector<std::string_view> stored;
+    for (int i = 0; i < 20000; ++i) {
+        stored.push_back(arena.store("word" + std::to_string(i)));
+    }
+    for (int i = 0; i < 20000; ++i) {
+        ASSERT_EQUAL(stored[i], "word" + std::to_string(i));
+    }
+    // Много коротких строк укладываются в несколько больших блоков
+    ASSERT(arena.blockCount() < 10);
+
+    // Выравнивание соблюдается после невыровненных строк
+    arena.store("x");
+    void* aligned = arena.allocate(sizeof(uint64_t), alignof(uint64_t));
+    ASSERT_EQUAL(reinterpret_cast<uintptr_t>(aligned) % alignof(uint64_t), 0u);
+
+    // Длинная строка получает собственный блок
+    std::string longWord(1 << 20, 'q');
+    ASSERT_EQUAL(arena.store(longWord), longWord);
+}
+
+void TestApproximateCounter() {
+    // Поток с распределением Ципфа: первые слова встречаются намного чаще
+    std::mt19937 rng(7);
+    std::vector<double> weights;
+    for (int i = 1; i <= 5000; ++i) {
+        weights.push_back(1.0 / i);
+    }
+    std::discrete_distribution<int> pick(weights.begin(), weights.end());
+
+    WordCounter exact(WordCounter::Backend::Hash);
+    ApproximateCounter approx(64 * 1024);
+    for (int i = 0; i < 200000; ++i) {
+        std::string word = "w" + std::to_string(pick(rng));
+        exact.addWord(word);
+        approx.addWord(word);
+    }
+    ASSERT_EQUAL(approx.getTotalWords(), exact.getTotalWords());
+    ASSERT(approx.getMemoryUsage() <= 64 * 1024);
+
+    // Самые частые слова найдены, а истинная частота лежит внутри границ
+    std::vector<ApproximateCounter::Entry> top = approx.getTopK(10);
+    std::vector<WordCounter::Entry> expected = exact.getTopK(10);
+    ASSERT_EQUAL(top.size(), expected.size());
+    for (size_t i = 0; i < top.size(); ++i) {
+        uint64_t actual = exact.getFrequency(top[i].word);
+        ASSERT(top[i].lowerBound <= actual);
+        ASSERT(actual <= top[i].estimate);
+        ASSERT(top[i].estimate - actual <= approx.getErrorBound());
+    }
+    ASSERT_EQUAL(top[0].word, expected[0].first);
+
+    // Пока все слова помещаются, подсчет точный
+    ApproximateCounter small(64 * 1024);
+    for (std::string_view word : {"b", "a", "b", "c", "b", "a"}) {
+        small.addWord(word);
+    }
+    small.addWord("");
+    std::vector<ApproximateCounter::Entry> smallTop = small.getTopK(5);
+    ASSERT_EQUAL(smallTop.size(), 3u);
+    ASSERT_EQUAL(smallTop[0].word, "b");
+    ASSERT_EQUAL(smallTop[0].estimate, 3u);
+    ASSERT_EQUAL(smallTop[0].lowerBound, 3u);
+    ASSERT_EQUAL(smallTop[1].word, "a");
+    ASSERT_EQUAL(smallTop[2].word, "c");
+
+    // Длинные слова (больше SSO std::string) не выводят память за бюджет
+    const size_t budget = 64 * 1024;
+    ApproximateCounter longWords(budget);
+    std::string frequent(SpaceSaving::MAX_WORD_BYTES, 'f');
+    for (int i = 0; i < 100000; ++i) {
+        std::string word(16 + i % (SpaceSaving::MAX_WORD_BYTES - 16), 'a' + i % 26);
+        word += std::to_string(i);
+        longWords.addWord(word);
+        longWords.addWord(frequent);
+        // Слишком длинные слова учитываются только в общем числе и в sketch
+        longWords.addWord(std::string(SpaceSaving::MAX_WORD_BYTES + 1 + i % 100, 'z'));
+    }
+    ASSERT(longWords.getMemoryUsage() <= budget);
+    ASSERT_EQUAL(longWords.getTotalWords(), 300000u);
+    std::vector<ApproximateCounter::Entry> longTop = longWords.getTopK(1);
+    ASSERT_EQUAL(longTop[0].word, frequent);
+    ASSERT(longTop[0].lowerBound <= 100000u && 100000u <= longTop[0].estimate);
+
+    // Память Space-Saving измеряется по массивам и укладывается в бюджет
+    SpaceSaving heavy(SpaceSaving::capacityForMemory(8192));
+    for (int i = 0; i < 10000; ++i) {
+        std::string word = std::string(40, 'w') + std::to_string(i);
+        heavy.add(word, FlatWordTable::hashWord(word));
+    }
+    ASSERT_EQUAL(heavy.size(), heavy.getCapacity());
+    ASSERT(heavy.memoryUsage() <= 8192u);
+    for (const SpaceSaving::Item& item : heavy.top(heavy.size())) {
+        ASSERT(item.word.size() > 40);
+        ASSERT(item.count > item.error);
+    }
+}
+
+void TestProcessFiles() {
+    // Каталог с вложенным подкаталогом и пустым файлом
+    const std::filesystem::path dir = "test_batch_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "nested");
+    std::vector<std::string> texts = {"one two two", "Three three THREE", "", "two one"};
+    std::vector<std::filesystem::path> paths = {
+        dir / "a.txt", dir / "b.txt", dir / "nested" / "empty.txt", dir / "nested" / "c.txt"
+    };
+    std::string all;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        std::ofstream out(paths[i], std::ios::binary);
+        out << texts[i];
+        all += texts[i] + "\n";
+    }
+
+    std::vector<std::string> files = FileReader::listFiles({dir.string()});
+    ASSERT_EQUAL(files.size(), 4u);
+
+    WordCounter expected;
+    WordProcessor::processBuffer(all.data(), all.size(), expected);
+    for (unsigned threads : {1u, 2u, 8u}) {
+        WordCounter counter;
+        uint64_t bytes = WordProcessor::processFiles(files, counter, threads);
+        ASSERT_EQUAL(bytes, static_cast<uint64_t>(all.size() - texts.size()));
+        ASSERT_EQUAL(counter.getSortedWords(), expected.getSortedWords());
+    }
+
+    // Ошибка в одном из файлов передается вызывающему
+    files.push_back((dir / "missing.txt").string());
+    WordCounter counter;
+    ASSERT_THROWS(WordProcessor::processFiles(files, counter, 2), std::runtime_error);
+
+    std::filesystem::remove_all(dir);
+}
+
+void TestProcessBufferParallel() {
+    // Слова разной длины с многобайтовыми символами: при переборе длин
+    // буфера границы частей попадают внутрь слов и последовательностей UTF-8
+    std::string utf8Text = "Привет мир, ёж и Ёлка! naïve café ПРИВЕТ 日本語 мир\nsecond line мир ёж";
+    std::string asciiText = "The quick brown fox, the lazy dog; THE end\nfox and dog";
+    struct Case {
+        std::string text;
+        WordScanner::Encoding encoding;
+    };
+    std::vector<Case> cases = {
+        {asciiText, WordScanner::Encoding::Ascii},
+        {utf8Text, WordScanner::Encoding::Utf8},
+        // Буфер из одного слова разрезать негде
+        {std::string(100, 'x'), WordScanner::Encoding::Ascii},
+        {"ж" + std::string(60, 'z') + "ж", WordScanner::Encoding::Utf8}
+    };
+
+    for (const Case& c : cases) {
+        for (size_t size = 0; size <= c.text.size(); ++size) {
+            // В UTF-8 обрезаем префикс по границе символа
+            if (c.encoding == WordScanner::Encoding::Utf8 && size < c.text.size() &&
+                (static_cast<unsigned char>(c.text[size]) & 0xC0) == 0x80) {
+                continue;
+            }
+            WordCounter expected;
+            WordProcessor::processBuffer(c.text.data(), size, expected, c.encoding);
+
+            WordCounter fromLines;
+            WordProcessor::processLines({c.text.substr(0, size)}, fromLines, c.encoding);
+            ASSERT_EQUAL(fromLines.getSortedWords(), expected.getSortedWords());
+
+            for (unsigned threads : {1u, 2u, 3u, 8u}) {
+                WordCounter parallel;
+                WordProcessor::processBufferParallel(c.text.data(), size, parallel, threads, c.encoding);
+                ASSERT_EQUAL(parallel.getSortedWords(), expected.getSortedWords());
+                ASSERT_EQUAL(parallel.getTotalWords(), expected.getTotalWords());
+            }
+        }
+    }
+}
+
+void TestNGramCounter() {
+    std::string text = "the cat and the cat and the dog. The cat!";
+    std::vector<std::string> words = referenceWords(text);
+
+    for (size_t n = NGramCounter::MIN_N; n <= NGramCounter::MAX_N; ++n) {
+        // Эталон: склеиваем каждые n соседних слов
+        std::map<std::string, uint64_t> expected;
+        for (size_t i = 0; i + n <= words.size(); ++i) {
+            std::string phrase = words[i];
+            for (size_t j = 1; j < n; ++j) {
+                phrase += " " + words[i + j];
+            }
+            expected[phrase]++;
+        }
+
+        // Текст разрезан на два буфера: n-граммы продолжаются через границу
+        WordCounter counter;
+        NGramCounter ngrams(n);
+        WordProcessor::Extras extras;
+        extras.ngrams = &ngrams;
+        WordProcessor::processBuffer(text.data(), 12, counter, extras);
+        WordProcessor::processBuffer(text.data() + 12, text.size() - 12, counter, extras);
+        ASSERT_EQUAL(counter.getTotalWords(), static_cast<uint64_t>(words.size()));
+        ASSERT_EQUAL(ngrams.getTotalNGrams(), static_cast<uint64_t>(words.size() - n + 1));
+        ASSERT_EQUAL(ngrams.getDistinctNGrams(), expected.size());
+        for (const auto& [phrase, count] : expected) {
+            ASSERT_EQUAL(ngrams.getFrequency(phrase), count);
+        }
+
+        std::vector<WordCounter::Entry> sorted = ngrams.getSortedNGrams();
+        ASSERT_EQUAL(sorted.size(), expected.size());
+        for (size_t i = 1; i < sorted.size(); ++i) {
+            ASSERT(sorted[i - 1].second > sorted[i].second ||
+                   (sorted[i - 1].second == sorted[i].second && sorted[i - 1].first < sorted[i].first));
+        }
+    }
+
+    NGramCounter bigrams(2);
+    for (std::string_view word : {"a", "b", "a", "b"}) {
+        bigrams.addWord(word);
+    }
+    std::vector<WordCounter::Entry> top = bigrams.getSortedNGrams(1);
+    ASSERT_EQUAL(top.size(), 1u);
+    ASSERT_EQUAL(top[0].first, "a b");
+    ASSERT_EQUAL(top[0].second, 2u);
+    ASSERT_EQUAL(bigrams.getFrequency("b a"), 1u);
+    ASSERT_EQUAL(bigrams.getFrequency("a b a"), 0u);
+
+    // После reset n-грамма не захватывает слова до сброса
+    bigrams.reset();
+    bigrams.addWord("c");
+    ASSERT_EQUAL(bigrams.getFrequency("b c"), 0u);
+
+    ASSERT_EQUAL(bigrams.getN(), 2u);
+
+    // Память учитывает словарь: текст всех различных слов и их номера
+    NGramCounter vocabulary(3);
+    size_t textBytes = 0;
+    for (int i = 0; i < 10000; ++i) {
+        std::string word = "word" + std::to_string(i);
+        textBytes += word.size();
+        vocabulary.addWord(word);
+    }
+    ASSERT_EQUAL(vocabulary.getFrequency("word0 word1 word2"), 1u);
+    ASSERT(vocabulary.getMemoryUsage() >= textBytes + 10000 * sizeof(std::string_view));
+
+    ASSERT_THROWS(NGramCounter(1), std::invalid_argument);
+    ASSERT_THROWS(NGramCounter(5), std::invalid_argument);
+}
+
+void TestCorpusHistograms() {
+    // Текст больше блока разбора, с длинным словом и пустыми строками
+    std::mt19937 rng(3);
+    std::string text;
+    while (text.size() < 300000) {
+        size_t length = rng() % 12;
+        for (size_t i = 0; i < length; ++i) {
+            text += static_cast<char>('a' + rng() % 26);
+        }
+        text += (rng() % 5 == 0) ? '\n' : ' ';
+    }
+    text += std::string(100000, 'x') + "\n\nlast line";
+
+    WordCounter counter;
+    CorpusHistograms histograms;
+    WordProcessor::Extras extras;
+    extras.histograms = &histograms;
+    WordProcessor::processBuffer(text.data(), text.size(), counter, extras);
+    histograms.finish();
+
+    // Те же слова, что и без гистограмм
+    WordCounter expected;
+    WordProcessor::processBuffer(text.data(), text.size(), expected);
+    ASSERT_EQUAL(counter.getSortedWords(), expected.getSortedWords());
+
+    std::vector<uint64_t> bytes(256, 0);
+    std::vector<uint64_t> lines(CorpusHistograms::MAX_LINE_LENGTH + 1, 0);
+    size_t lineLength = 0;
+    for (char c : text) {
+        bytes[static_cast<unsigned char>(c)]++;
+        if (c == '\n') {
+            lines[std::min(lineLength, CorpusHistograms::MAX_LINE_LENGTH)]++;
+            lineLength = 0;
+        } else {
+            lineLength++;
+        }
+    }
+    lines[lineLength]++;
+    for (unsigned b = 0; b < 256; ++b) {
+        ASSERT_EQUAL(histograms.getByteCount(static_cast<unsigned char>(b)), bytes[b]);
+    }
+    ASSERT_EQUAL(histograms.getLineLengths(), lines);
+
+    std::vector<uint64_t> words(CorpusHistograms::MAX_WORD_LENGTH + 1, 0);
+    for (const auto& word : referenceWords(text)) {
+        words[std::min(word.size(), CorpusHistograms::MAX_WORD_LENGTH)]++;
+    }
+    ASSERT_EQUAL(histograms.getWordLengths(), words);
+    ASSERT_EQUAL(histograms.wordLengthRows().back().first, "64+");
+
+    // Построчный режим видит те же байты, что и весь файл целиком,
+    // в том числе когда последняя строка не завершена переводом строки
+    const std::string filename = "test_histograms.txt";
+    for (const std::string& content : {std::string("one two\nthree\n"), std::string("one two\nthree")}) {
+        {
+            std::ofstream out(filename, std::ios::binary);
+            out << content;
+        }
+        bool lastLineTerminated = true;
+        std::vector<std::string> fileLines = FileReader(filename).readLines(&lastLineTerminated);
+        ASSERT_EQUAL(lastLineTerminated, content.back() == '\n');
+
+        WordCounter byLines;
+        CorpusHistograms linesHistograms;
+        WordProcessor::Extras linesExtras;
+        linesExtras.histograms = &linesHistograms;
+        WordProcessor::processLines(fileLines, byLines, linesExtras, WordScanner::Encoding::Ascii,
+                                    lastLineTerminated);
+        linesHistograms.finish();
+
+        WordCounter byBuffer;
+        CorpusHistograms bufferHistograms;
+        WordProcessor::Extras bufferExtras;
+        bufferExtras.histograms = &bufferHistograms;
+        WordProcessor::processBuffer(content.data(), content.size(), byBuffer, bufferExtras);
+        bufferHistograms.finish();
+
+        ASSERT_EQUAL(linesHistograms.byteRows(), bufferHistograms.byteRows());
+        ASSERT_EQUAL(linesHistograms.getLineLengths(), bufferHistograms.getLineLengths());
+    }
+    std::remove(filename.c_str());
+
+    // Длина слова в UTF-8 считается в символах
+    CorpusHistograms utf8;
+    utf8.addWord("слово");
+    ASSERT_EQUAL(utf8.getWordLengths()[5], 1u);
+}
+
+void TestStopWords() {
+    // Большой список: каждое слово находится, а похожие - нет
+    std::vector<std::string> list;
+    for (int i = 0; i < 5000; ++i) {
+        list.push_back("stop" + std::to_string(i));
+    }
+    list.push_back("stop7");
+    list.push_back("");
+    StopWords stopWords(list);
+    ASSERT_EQUAL(stopWords.size(), 5000u);
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT(stopWords.contains("stop" + std::to_string(i)));
+        ASSERT(!stopWords.contains("stop" + std::to_string(i + 5000)));
+    }
+    ASSERT(!stopWords.contains(""));
+    ASSERT(!stopWords.contains("stop"));
+
+    StopWords empty;
+    ASSERT(!empty.contains("the"));
+
+    // Файл разбирается так же, как вход: регистр и разделители не важны
+    const std::string filename = "test_stopwords.txt";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out << "The, A\nAND\n\nи в";
+    }
+    StopWords fromFile = StopWords::fromFile(filename, WordScanner::Encoding::Utf8);
+    std::remove(filename.c_str());
+    ASSERT_EQUAL(fromFile.size(), 5u);
+    ASSERT(fromFile.contains("the") && fromFile.contains("and") && fromFile.contains("в"));
+    ASSERT(!fromFile.contains("The"));
+}
+
+void TestWordFilter() {
+    ASSERT_EQUAL(Stemmer::stem("counting"), "count");
+    ASSERT_EQUAL(Stemmer::stem("counted"), "count");
+    ASSERT_EQUAL(Stemmer::stem("caresses"), "caress");
+    ASSERT_EQUAL(Stemmer::stem("ponies"), "poni");
+    ASSERT_EQUAL(Stemmer::stem("cats"), "cat");
+    ASSERT_EQUAL(Stemmer::stem("bus"), "bus");
+    ASSERT_EQUAL(Stemmer::stem("sing"), "sing");
+    ASSERT_EQUAL(Stemmer::stem("книгами"), "книг");
+    ASSERT_EQUAL(Stemmer::stem("книга"), "книг");
+    ASSERT_EQUAL(Stemmer::stem("дом"), "дом");
+    ASSERT_EQUAL(Stemmer::stem(""), "");
+
+    // Основа - начало исходного слова, без копирования
+    std::string word = "walking";
+    ASSERT(Stemmer::stem(word).data() == word.data());
+
+    WordFilter filter(StopWords({"the", "и"}), true);
+    std::string text = "The cats and the dogs. И коты, и книгами";
+    WordCounter counter;
+    WordProcessor::Extras extras;
+    extras.filter = &filter;
+    WordProcessor::processBuffer(text.data(), text.size(), counter, extras, WordScanner::Encoding::Utf8);
+    ASSERT_EQUAL(counter.getFrequency("the"), 0u);
+    ASSERT_EQUAL(counter.getFrequency("и"), 0u);
+    ASSERT_EQUAL(counter.getFrequency("cat"), 1u);
+    ASSERT_EQUAL(counter.getFrequency("dog"), 1u);
+    ASSERT_EQUAL(counter.getFrequency("книг"), 1u);
+    ASSERT_EQUAL(counter.getTotalWords(), 5u);
+
+    // Параллельный подсчет применяет тот же фильтр
+    WordCounter parallel;
+    WordProcessor::processBufferParallel(text.data(), text.size(), parallel, 3, WordScanner::Encoding::Utf8, &filter);
+    ASSERT_EQUAL(parallel.getSortedWords(), counter.getSortedWords());
+}
+
+void TestSortedWordsOrder() {
+    // Частоты по закону Ципфа, в том числе выше порога сортировки подсчетом.
+    // Многие слова делят одну частоту, так что порядок по алфавиту важен
+    std::mt19937 rng(11);
+    std::vector<std::pair<std::string, int>> input;
+    for (int i = 1; i <= 5000; ++i) {
+        input.emplace_back("w" + std::to_string(rng() % 100000), 100000 / i);
+    }
+
+    for (auto backend : {WordCounter::Backend::Tree, WordCounter::Backend::Hash}) {
+        WordCounter counter(backend);
+        for (const auto& [word, frequency] : input) {
+            for (int i = 0; i < frequency; ++i) {
+                counter.addWord(word);
+            }
+        }
+
+        std::vector<WordCounter::Entry> sorted = counter.getSortedWords();
+        std::vector<WordCounter::Entry> expected = sorted;
+        std::sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        });
+        ASSERT_EQUAL(sorted, expected);
+        ASSERT_EQUAL(sorted.size(), counter.getDistinctWords());
+        ASSERT(sorted.front().second >= (1 << 16));
+    }
+
+    WordCounter empty;
+    ASSERT(empty.getSortedWords().empty());
+}
+
+void TestWideCounts() {
+    // Частоты больше 2^32 не переполняются ни в одной таблице
+    const uint64_t big = 3000000000ULL;
+    TreeWordTable tree;
+    FlatWordTable wide;
+    FlatWordTable compact(true);
+    for (WordTable* table : std::initializer_list<WordTable*>{&tree, &wide, &compact}) {
+        table->add("big", big);
+        table->add("big", big);
+        table->add("small", 1);
+        // Перестроение таблицы сохраняет старшие половины частот
+        for (int i = 0; i < 5000; ++i) {
+            table->add("w" + std::to_string(i), 1);
+        }
+        ASSERT_EQUAL(table->find("big"), 2 * big);
+        ASSERT_EQUAL(table->find("small"), 1u);
+    }
+
+    // Компактная таблица переходит на 64 бита только при необходимости
+    FlatWordTable stillCompact(true);
+    stillCompact.add("word", 5);
+    ASSERT(!stillCompact.hasWideCounts());
+    ASSERT(compact.hasWideCounts());
+    ASSERT(stillCompact.memoryUsage() < FlatWordTable().memoryUsage());
+
+    // Снимок хранит 64-битные частоты
+    const std::string filename = "test_wide_snapshot.bin";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        compact.saveSnapshot(out);
+    }
+    WordCounter loaded(WordCounter::Backend::Compact);
+    loaded.loadSnapshot(filename);
+    ASSERT_EQUAL(loaded.getFrequency("big"), 2 * big);
+    ASSERT_EQUAL(loaded.getTotalWords(), 2 * big + 5001);
+    WordCounter merged(WordCounter::Backend::Tree);
+    merged.loadSnapshot(filename);
+    merged.merge(loaded);
+    ASSERT_EQUAL(merged.getFrequency("big"), 4 * big);
+    ASSERT_EQUAL(merged.getTotalWords(), 2 * (2 * big + 5001));
+    std::remove(filename.c_str());
+
+    // Снимки первой версии с 32-битными частотами по-прежнему читаются
+    {
+        std::ofstream out(filename, std::ios::binary);
+        const char magic[8] = {'W', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+        uint32_t header[2] = {1, 0x01020304};
+        uint64_t sizes[3] = {2, 1, 2};
+        out.write(magic, sizeof(magic));
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+        uint64_t hashOffset[2] = {FlatWordTable::hashWord("hi"), 0};
+        uint32_t lengthCount[2] = {2, 7};
+        out.write(reinterpret_cast<const char*>(hashOffset), sizeof(hashOffset));
+        out.write(reinterpret_cast<const char*>(lengthCount), sizeof(lengthCount));
+        std::string empty(24, '\0');
+        out.write(empty.data(), empty.size());
+        out << "hi";
+    }
+    WordCounter old(WordCounter::Backend::Hash);
+    old.loadSnapshot(filename);
+    ASSERT_EQUAL(old.getFrequency("hi"), 7u);
+    ASSERT_EQUAL(old.getTotalWords(), 7u);
+    std::remove(filename.c_str());
+}
+
+void TestAsyncReader() {
+    // Слова длиннее буфера и слова на стыках буферов
+    std::string text = "Alpha beta,gamma\nDELTA " + std::string(50, 'z') + " epsilon 123 " + std::string(7, 'y');
+    const std::string filename = "test_async_reader.txt";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out << text;
+    }
+
+    for (size_t chunk : {1u, 3u, 7u, 16u, 1024u}) {
+        for (size_t buffers : {2u, 4u}) {
+            std::string joined;
+            std::vector<std::string> words;
+            AsyncReader reader(filename, chunk, buffers);
+            reader.readChunks([&joined, &words](const char* data, size_t size) {
+                std::string block(data, size);
+                joined += block;
+                for (const auto& word : WordProcessor::extractWords(block)) {
+                    words.push_back(word);
+                }
+            });
+            // Байты приходят по порядку, каждый ровно один раз
+            ASSERT_EQUAL(joined, text);
+            ASSERT_EQUAL(words, referenceWords(text));
+        }
+    }
+
+    // Исключение из обработчика останавливает фоновое чтение
+    size_t calls = 0;
+    ASSERT_THROWS(AsyncReader(filename, 4).readChunks([&calls](const char*, size_t) {
+        if (++calls == 2) {
+            throw std::logic_error("stop");
+        }
+    }), std::logic_error);
+    ASSERT_EQUAL(calls, 2u);
+
+    std::remove(filename.c_str());
+    ASSERT_THROWS(AsyncReader("non_existent.txt").readChunks([](const char*, size_t) {}),
+                  std::runtime_error);
+}
+
+void TestAll() {
+    TestRunner tr;
+    RUN_TEST(tr, TestAssertThrows);
+    RUN_TEST(tr, TestExtractWords);
+    RUN_TEST(tr, TestScannerImplementationsAgree);
+    RUN_TEST(tr, TestTopK);
+    RUN_TEST(tr, TestCSVWriterFormat);
+    RUN_TEST(tr, TestStreamReaderChunks);
+    RUN_TEST(tr, TestMappedFile);
+    RUN_TEST(tr, TestSnapshotRoundTrip);
+    RUN_TEST(tr, TestUtf8Words);
+    RUN_TEST(tr, TestStringArena);
+    RUN_TEST(tr, TestApproximateCounter);
+    RUN_TEST(tr, TestProcessFiles);
+    RUN_TEST(tr, TestProcessBufferParallel);
+    RUN_TEST(tr, TestNGramCounter);
+    RUN_TEST(tr, TestCorpusHistograms);
+    RUN_TEST(tr, TestStopWords);
+    RUN_TEST(tr, TestWordFilter);
+    RUN_TEST(tr, TestSortedWordsOrder);
+    RUN_TEST(tr, TestWideCounts);
+    RUN_TEST(tr, TestAsyncReader);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+void TestAssertThrows();
+void TestExtractWords();
+void TestScannerImplementationsAgree();
+void TestTopK();
+void TestCSVWriterFormat();
+void TestStreamReaderChunks();
+void TestMappedFile();
+void TestSnapshotRoundTrip();
+void TestUtf8Words();
+void TestStringArena();
+void TestApproximateCounter();
+void TestProcessFiles();
+void TestProcessBufferParallel();
+void TestNGramCounter();
+void TestCorpusHistograms();
+void TestStopWords();
+void TestWordFilter();
+void TestSortedWordsOrder();
+void TestWideCounts();
+void TestAsyncReader();
+
+void TestAll();
@@ -0,0 +1,6 @@
+#include "Tests.h"
+
+int main() {
+    TestAll();
+    return 0;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <map>
+#include <set>
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+
+using namespace std;
+
+template <class T, class U>
+ostream& operator << (ostream& os, const pair<T, U>& p) {
+    return os << p.first << " " << p.second;
+}
+
+template <class T>
+ostream& operator << (ostream& os, const vector<T>& s) {
+  os << "{";
+  bool first = true;
+  for (const auto& x : s) {
+    if (!first) {
+      os << ", ";
+    }
+    first = false;
+    os << x;
+  }
+  return os << "}";
+}
+
+template <class T>
+ostream& operator << (ostream& os, const set<T>& s) {
+  os << "{";
+  bool first = true;
+  for (const auto& x : s) {
+    if (!first) {
+      os << ", ";
+    }
+    first = false;
+    os << x;
+  }
+  return os << "}";
+}
+
+template <class K, class V>
+ostream& operator << (ostream& os, const map<K, V>& m) {
+  os << "{";
+  bool first = true;
+  for (const auto& kv : m) {
+    if (!first) {
+      os << ", ";
+    }
+    first = false;
+    os << kv.first << ": " << kv.second;
+  }
+  return os << "}";
+}
+
+template<class T, class U>
+void AssertEqual(const T& t, const U& u, const string& hint = {}) {
+  if (!(t == u)) {
+    ostringstream os;
+    os << "Assertion failed: " << t << " != " << u;
+    if (!hint.empty()) {
+       os << " hint: " << hint;
+    }
+    throw runtime_error(os.str());
+  }
+}
+
+inline void Assert(bool b, const string& hint) {
+  AssertEqual(b, true, hint);
+}
+
+class TestRunner {
+public:
+  template <class TestFunc>
+  void RunTest(TestFunc func, const string& test_name) {
+    try {
+      func();
+      cerr << test_name << " OK" << endl;
+    } catch (exception& e) {
+      ++fail_count;
+      cerr << test_name << " fail: " << e.what() << endl;
+    } catch (...) {
+      ++fail_count;
+      cerr << "Unknown exception caught" << endl;
+    }
+  }
+
+  ~TestRunner() {
+    if (fail_count > 0) {
+      cerr << fail_count << " unit tests failed. Terminate" << endl;
+      exit(1);
+    }
+  }
+
+private:
+  int fail_count = 0;
+};
+
+#define ASSERT_EQUAL(x, y) {                  \
+  ostringstream error_os;                     \
+  error_os << #x << " != " << #y << ", "      \
+    << __FILE__ << ":" << __LINE__;           \
+  AssertEqual(x, y, error_os.str());          \
+}
+
+#define ASSERT(x) {                     \
+  ostringstream error_os;                     \
+  error_os << #x << " is false, "             \
+    << __FILE__ << ":" << __LINE__;     \
+  Assert(x, error_os.str());      \
+}
+
+#define RUN_TEST(tr, func) \
+  tr.RunTest(func, #func)
+
+#define ASSERT_THROWS(expr, exception_type) {                            \
+  bool thrown_expected = false;                                           \
+  try {                                                                   \
+    expr;                                                                 \
+  } catch (const exception_type&) {                                       \
+    thrown_expected = true;                                               \
+  } catch (const std::exception& e) {                                     \
+    ostringstream os;                                                     \
+    os << #expr << " threw wrong exception type (" << e.what() << "), "   \
+      << __FILE__ << ":" << __LINE__;                                     \
+    throw runtime_error(os.str());                                        \
+  } catch (...) {                                                         \
+    ostringstream os;                                                     \
+    os << #expr << " threw wrong exception type, "                        \
+      << __FILE__ << ":" << __LINE__;                                     \
+    throw runtime_error(os.str());                                        \
+  }                                                                       \
+  if (!thrown_expected) {                                                 \
+    ostringstream os;                                                     \
+    os << #expr << " did not throw " << #exception_type << ", "           \
+      << __FILE__ << ":" << __LINE__;                                     \
+    throw runtime_error(os.str());                                        \
+  }                                                                       \
+}
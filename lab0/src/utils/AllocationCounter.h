@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// Счетчики выделений динамической памяти. Глобальные operator new и
+// operator delete заменены в AllocationCounter.cpp (он подключается только
+// к приложению). Пока учет не включен, operator new лишь проверяет флаг
+class AllocationCounter {
+public:
+    // Начать учет выделений; вызывается PipelineStats, когда замеры включены
+    static void enable();
+
+    // Сколько раз выделялась память с начала работы программы
+    static uint64_t allocations();
+
+    // Сколько байтов выделено с начала работы программы
+    static uint64_t allocatedBytes();
+};
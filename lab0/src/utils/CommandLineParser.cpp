@@ -0,0 +1,259 @@
+#include "CommandLineParser.h"
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../core/NGramCounter.h"
+
+namespace {
+
+// Проверить, что аргумент - это параметр name в форме "--name" или "--name=..."
+bool isOption(const std::string& arg, const std::string& name) {
+    return arg == name || arg.compare(0, name.size() + 1, name + "=") == 0;
+}
+
+// Разобрать неотрицательное целое значение параметра name
+unsigned long long parseNumber(const std::string& value, const std::string& name) {
+    size_t pos = 0;
+    unsigned long long number = 0;
+    try {
+        if (!value.empty() && value[0] != '-') {
+            number = std::stoull(value, &pos);
+        }
+    } catch (const std::exception&) {
+        pos = 0;
+    }
+    if (pos == 0 || pos != value.size()) {
+        throw std::invalid_argument("Invalid value for " + name + ": " + value);
+    }
+    return number;
+}
+
+// Разобрать число потоков; 0 означает "по числу ядер"
+unsigned parseThreadCount(const std::string& value) {
+    unsigned long long count = parseNumber(value, "--threads");
+    if (count > 1024) {
+        throw std::invalid_argument("Invalid thread count: " + value);
+    }
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return static_cast<unsigned>(count);
+}
+
+// Разобрать объем памяти: число байтов с необязательным суффиксом K, M или G
+size_t parseMemorySize(const std::string& value, const std::string& name) {
+    std::string digits = value;
+    unsigned long long multiplier = 1;
+    if (!digits.empty()) {
+        char suffix = digits.back();
+        if (suffix == 'K' || suffix == 'k') {
+            multiplier = 1ULL << 10;
+        } else if (suffix == 'M' || suffix == 'm') {
+            multiplier = 1ULL << 20;
+        } else if (suffix == 'G' || suffix == 'g') {
+            multiplier = 1ULL << 30;
+        }
+        if (multiplier != 1) {
+            digits.pop_back();
+        }
+    }
+    unsigned long long bytes = parseNumber(digits, name);
+    if (bytes == 0 || bytes > (1ULL << 40) / multiplier) {
+        throw std::invalid_argument("Invalid value for " + name + ": " + value);
+    }
+    return static_cast<size_t>(bytes * multiplier);
+}
+
+}
+
+CommandLineParser::CommandLineParser(int argc, char* argv[])
+    : argc_(argc), argv_(argv) {}
+
+std::string CommandLineParser::takeValue(int& i, const std::string& arg, const std::string& name) const {
+    if (arg.size() > name.size()) {
+        return arg.substr(name.size() + 1);
+    }
+    if (i + 1 >= argc_) {
+        throw std::invalid_argument("Missing value for " + name);
+    }
+    return argv_[++i];
+}
+
+ProgramOptions CommandLineParser::parse() const {
+    ProgramOptions options;
+    std::vector<std::string> positional;
+    bool threadsGiven = false;  // --threads задан явно
+
+    for (int i = 1; i < argc_; ++i) {
+        std::string arg = argv_[i];
+
+        if (arg == "--mmap") {
+            options.inputMode = InputMode::Mmap;
+        } else if (arg == "--async") {
+            options.inputMode = InputMode::Async;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--stem") {
+            options.stem = true;
+        } else if (arg == "--stream") {
+            options.inputMode = InputMode::Stream;
+        } else if (isOption(arg, "--backend")) {
+            std::string value = takeValue(i, arg, "--backend");
+            if (value == "tree") {
+                options.backend = WordCounter::Backend::Tree;
+            } else if (value == "hash") {
+                options.backend = WordCounter::Backend::Hash;
+            } else if (value == "compact") {
+                options.backend = WordCounter::Backend::Compact;
+            } else {
+                throw std::invalid_argument("Unknown backend: " + value);
+            }
+        } else if (isOption(arg, "--encoding")) {
+            std::string value = takeValue(i, arg, "--encoding");
+            if (value == "ascii") {
+                options.encoding = WordScanner::Encoding::Ascii;
+            } else if (value == "utf8") {
+                options.encoding = WordScanner::Encoding::Utf8;
+            } else {
+                throw std::invalid_argument("Unknown encoding: " + value);
+            }
+        } else if (isOption(arg, "--threads")) {
+            options.threads = parseThreadCount(takeValue(i, arg, "--threads"));
+            threadsGiven = true;
+        } else if (isOption(arg, "--top")) {
+            options.top = parseNumber(takeValue(i, arg, "--top"), "--top");
+            if (options.top == 0) {
+                throw std::invalid_argument("--top must be positive");
+            }
+        } else if (isOption(arg, "--snapshot-in")) {
+            options.snapshotIn = takeValue(i, arg, "--snapshot-in");
+        } else if (isOption(arg, "--snapshot-out")) {
+            options.snapshotOut = takeValue(i, arg, "--snapshot-out");
+        } else if (isOption(arg, "--stats-json")) {
+            options.statsJson = takeValue(i, arg, "--stats-json");
+        } else if (isOption(arg, "--ngrams")) {
+            options.ngrams = parseNumber(takeValue(i, arg, "--ngrams"), "--ngrams");
+            if (options.ngrams < NGramCounter::MIN_N || options.ngrams > NGramCounter::MAX_N) {
+                throw std::invalid_argument("--ngrams must be between 2 and 4");
+            }
+        } else if (isOption(arg, "--ngram-output")) {
+            options.ngramOutput = takeValue(i, arg, "--ngram-output");
+        } else if (isOption(arg, "--histograms")) {
+            options.histogramsPrefix = takeValue(i, arg, "--histograms");
+        } else if (isOption(arg, "--stopwords")) {
+            options.stopWordsFile = takeValue(i, arg, "--stopwords");
+        } else if (isOption(arg, "--approx")) {
+            options.approxMemory = parseMemorySize(takeValue(i, arg, "--approx"), "--approx");
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            throw std::invalid_argument("Unknown option: " + arg);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() < 2) {
+        throw std::invalid_argument("Expected input and output file names");
+    }
+
+    // Последний позиционный аргумент - выходной файл, остальные - входы
+    options.outputFile = positional.back();
+    positional.pop_back();
+    options.inputFiles = positional;
+    options.inputFile = positional.front();
+
+    std::error_code error;
+    options.batch = positional.size() > 1 || std::filesystem::is_directory(options.inputFile, error);
+    if (options.batch) {
+        if (std::find(positional.begin(), positional.end(), "-") != positional.end()) {
+            throw std::invalid_argument("Standard input cannot be combined with other inputs");
+        }
+        if (options.inputMode == InputMode::Stream || options.inputMode == InputMode::Async ||
+            options.approxMemory > 0) {
+            throw std::invalid_argument("Several inputs can only be counted exactly from mapped files");
+        }
+        // Файлы независимы, поэтому по умолчанию их считают все ядра
+        if (!threadsGiven) {
+            options.threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    // Стандартный ввод можно читать только потоково
+    if (options.inputFile == "-") {
+        if (options.inputMode == InputMode::Mmap || options.threads > 1) {
+            throw std::invalid_argument("Standard input can only be read with --stream or --async");
+        }
+        if (options.inputMode != InputMode::Async) {
+            options.inputMode = InputMode::Stream;
+        }
+    }
+    if ((options.inputMode == InputMode::Stream || options.inputMode == InputMode::Async) && options.threads > 1) {
+        throw std::invalid_argument("--threads cannot be combined with --stream or --async");
+    }
+
+    // Приближенный подсчет не хранит точную таблицу, поэтому ее нельзя
+    // ни делить между потоками, ни сохранять в снимок
+    if (options.approxMemory > 0) {
+        if (options.threads > 1) {
+            throw std::invalid_argument("--approx cannot be combined with --threads");
+        }
+        if (!options.snapshotIn.empty() || !options.snapshotOut.empty()) {
+            throw std::invalid_argument("--approx cannot be combined with snapshots");
+        }
+    }
+
+    // n-граммы идут через границы файлов и частей, поэтому считаются
+    // только в одном потоке по одному входу
+    if (options.ngrams > 0) {
+        if (options.ngramOutput.empty()) {
+            throw std::invalid_argument("--ngrams requires --ngram-output");
+        }
+        if (options.batch || options.threads > 1 || options.approxMemory > 0) {
+            throw std::invalid_argument("--ngrams cannot be combined with --threads, --approx or several inputs");
+        }
+        if (!options.snapshotIn.empty() || !options.snapshotOut.empty()) {
+            throw std::invalid_argument("--ngrams cannot be combined with snapshots");
+        }
+    } else if (!options.ngramOutput.empty()) {
+        throw std::invalid_argument("--ngram-output requires --ngrams");
+    }
+
+    // Гистограммы считаются в том же однопоточном проходе, что и слова
+    if (!options.histogramsPrefix.empty() &&
+        (options.batch || options.threads > 1 || options.approxMemory > 0)) {
+        throw std::invalid_argument("--histograms cannot be combined with --threads, --approx or several inputs");
+    }
+
+    return options;
+}
+
+std::string CommandLineParser::usage() const {
+    std::string programName = argc_ > 0 ? argv_[0] : "lab0";
+    return "Usage: " + programName + " [options] <input.txt|dir|-> [more inputs...] <output.csv>\n"
+           "  Input '-' reads words from standard input.\n"
+           "  Several inputs or a directory (read recursively) are counted into a single CSV\n"
+           "  by --threads workers (default - one per core), each mapping and counting the next file.\n"
+           "Options:\n"
+           "  --mmap                 map the input file into memory and count words without copying lines\n"
+           "  --stream               read the input in fixed-size blocks with bounded memory\n"
+           "  --async                like --stream, but a background thread reads ahead while words are counted\n"
+           "  --backend tree|hash|compact\n"
+           "                         word table: ordered std::map (default), open-addressing hash table,\n"
+           "                         or the hash table with 32-bit counts widened to 64 bits on overflow\n"
+           "  --encoding ascii|utf8  words are ASCII letters/digits (default) or Unicode letters/digits\n"
+           "  --threads N            count in N threads over the mapped file (0 - one per core)\n"
+           "  --top K                write only the K most frequent words\n"
+           "  --snapshot-in FILE     start from the counts saved in a snapshot\n"
+           "  --snapshot-out FILE    save the resulting counts as a binary snapshot\n"
+           "  --ngrams N             also count sequences of N words (2-4) in the same pass\n"
+           "  --ngram-output FILE    CSV file for the --ngrams counts (also limited by --top)\n"
+           "  --histograms PREFIX    also write word-length, byte and line-length histograms\n"
+           "                         to PREFIX.words.csv, PREFIX.bytes.csv and PREFIX.lines.csv\n"
+           "  --stopwords FILE       skip the words listed in FILE (parsed like the input)\n"
+           "  --stem                 count light stems: common English and Russian endings are cut\n"
+           "  --approx SIZE          approximate counting in fixed memory (bytes, or with K/M/G suffix);\n"
+           "                         writes the --top K (default 100) most frequent words with error bounds\n"
+           "  --stats                print per-stage timings and counters to stderr\n"
+           "  --stats-json FILE      write per-stage timings and counters as JSON\n";
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "../core/WordCounter.h"
+#include "../core/WordScanner.h"
+
+// Режим чтения входного файла
+enum class InputMode {
+    Lines,  // Построчное чтение через FileReader
+    Mmap,   // Отображение файла в память и разбор без копирования
+    Stream, // Чтение блоками фиксированного размера (в том числе со стандартного ввода)
+    Async   // То же, но следующие блоки читает фоновый поток, пока разбирается текущий
+};
+
+// Параметры запуска программы
+struct ProgramOptions {
+    std::string inputFile;  // "-" - стандартный ввод
+    std::vector<std::string> inputFiles;    // Все входные файлы и каталоги
+    bool batch = false;     // Несколько входов или каталог: файлы считаются пулом потоков
+    std::string outputFile;
+    InputMode inputMode = InputMode::Lines;
+    WordCounter::Backend backend = WordCounter::Backend::Tree;
+    WordScanner::Encoding encoding = WordScanner::Encoding::Ascii;
+    unsigned threads = 1;   // Больше одного потока - файл отображается в память; в пакетном режиме по умолчанию - по числу ядер
+    size_t top = 0;         // Сколько самых частых слов выводить (0 - все)
+    std::string snapshotIn;     // Снимок предыдущего подсчета, к которому добавляется вход
+    std::string snapshotOut;    // Куда сохранить снимок итогового подсчета
+    bool stats = false;         // Вывести замеры по стадиям в stderr
+    std::string statsJson;      // Записать замеры по стадиям в JSON файл
+    size_t ngrams = 0;          // Длина n-грамм для отдельного подсчета (0 - не считать)
+    std::string ngramOutput;    // CSV файл для n-грамм
+    std::string histogramsPrefix;   // Префикс CSV файлов с гистограммами корпуса (пусто - не считать)
+    std::string stopWordsFile;  // Список стоп-слов, которые не считаются
+    bool stem = false;          // Считать основы слов вместо самих слов
+    size_t approxMemory = 0;    // Бюджет памяти приближенного подсчета в байтах (0 - точный подсчет)
+};
+
+class CommandLineParser {
+private:
+    int argc_;
+    char** argv_;
+
+    // Получить значение параметра, заданного как "--name value" или "--name=value"
+    std::string takeValue(int& i, const std::string& arg, const std::string& name) const;
+
+public:
+    CommandLineParser(int argc, char* argv[]);
+
+    // Разобрать аргументы. При ошибке бросает std::invalid_argument
+    ProgramOptions parse() const;
+
+    // Текст подсказки по запуску
+    std::string usage() const;
+};
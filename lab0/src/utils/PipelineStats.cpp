@@ -0,0 +1,90 @@
+#include "PipelineStats.h"
+#include <algorithm>
+#include <iomanip>
+#include "AllocationCounter.h"
+
+PipelineStats::PipelineStats(bool enabled)
+    : enabled_(enabled), allocationsAtStart(0), allocatedBytesAtStart(0),
+      peakDistinctWords(0), peakTableBytes(0) {
+    if (enabled_) {
+        AllocationCounter::enable();
+    }
+}
+
+void PipelineStats::startStage(const std::string& name) {
+    if (!enabled_) {
+        return;
+    }
+    stages.push_back(Stage{});
+    stages.back().name = name;
+    allocationsAtStart = AllocationCounter::allocations();
+    allocatedBytesAtStart = AllocationCounter::allocatedBytes();
+    stageStart = std::chrono::steady_clock::now();
+}
+
+void PipelineStats::finishStage(uint64_t bytes, uint64_t words, uint64_t distinctWords, uint64_t tableBytes) {
+    if (!enabled_ || stages.empty()) {
+        return;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - stageStart;
+
+    Stage& stage = stages.back();
+    stage.seconds = elapsed.count();
+    stage.bytes = bytes;
+    stage.words = words;
+    stage.distinctWords = distinctWords;
+    stage.tableBytes = tableBytes;
+    stage.allocations = AllocationCounter::allocations() - allocationsAtStart;
+    stage.allocatedBytes = AllocationCounter::allocatedBytes() - allocatedBytesAtStart;
+
+    peakDistinctWords = std::max(peakDistinctWords, distinctWords);
+    peakTableBytes = std::max(peakTableBytes, tableBytes);
+}
+
+void PipelineStats::writeText(std::ostream& out) const {
+    out << std::left << std::setw(16) << "stage"
+        << std::right << std::setw(12) << "seconds"
+        << std::setw(14) << "bytes"
+        << std::setw(12) << "words"
+        << std::setw(12) << "distinct"
+        << std::setw(14) << "table bytes"
+        << std::setw(12) << "allocs"
+        << std::setw(14) << "alloc bytes" << "\n";
+
+    double totalSeconds = 0;
+    for (const Stage& stage : stages) {
+        out << std::left << std::setw(16) << stage.name
+            << std::right << std::setw(12) << std::fixed << std::setprecision(6) << stage.seconds
+            << std::setw(14) << stage.bytes
+            << std::setw(12) << stage.words
+            << std::setw(12) << stage.distinctWords
+            << std::setw(14) << stage.tableBytes
+            << std::setw(12) << stage.allocations
+            << std::setw(14) << stage.allocatedBytes << "\n";
+        totalSeconds += stage.seconds;
+    }
+
+    out << "total " << std::fixed << std::setprecision(6) << totalSeconds << " s, "
+        << "peak distinct words " << peakDistinctWords << ", "
+        << "peak table bytes " << peakTableBytes << "\n";
+}
+
+void PipelineStats::writeJson(std::ostream& out) const {
+    out << "{\n  \"stages\": [\n";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const Stage& stage = stages[i];
+        out << "    {\"name\": \"" << stage.name << "\""
+            << ", \"seconds\": " << std::setprecision(9) << stage.seconds
+            << ", \"bytes\": " << stage.bytes
+            << ", \"words\": " << stage.words
+            << ", \"distinct_words\": " << stage.distinctWords
+            << ", \"table_bytes\": " << stage.tableBytes
+            << ", \"allocations\": " << stage.allocations
+            << ", \"allocated_bytes\": " << stage.allocatedBytes
+            << "}" << (i + 1 < stages.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n"
+        << "  \"peak_distinct_words\": " << peakDistinctWords << ",\n"
+        << "  \"peak_table_bytes\": " << peakTableBytes << "\n"
+        << "}\n";
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Замеры по стадиям обработки: время, объем данных, слова, размер таблицы
+// и число выделений памяти. Включаются параметром --stats
+class PipelineStats {
+public:
+    struct Stage {
+        std::string name;
+        double seconds = 0;
+        uint64_t bytes = 0;             // Сколько байтов обработано
+        uint64_t words = 0;             // Сколько слов обработано
+        uint64_t distinctWords = 0;     // Различных слов в таблице после стадии
+        uint64_t tableBytes = 0;        // Размер таблицы после стадии
+        uint64_t allocations = 0;       // Выделений памяти за стадию
+        uint64_t allocatedBytes = 0;    // Байтов выделено за стадию
+    };
+
+private:
+    bool enabled_;
+    std::vector<Stage> stages;
+    std::chrono::steady_clock::time_point stageStart;
+    uint64_t allocationsAtStart;
+    uint64_t allocatedBytesAtStart;
+    uint64_t peakDistinctWords;
+    uint64_t peakTableBytes;
+
+public:
+    explicit PipelineStats(bool enabled);
+
+    bool enabled() const { return enabled_; }
+
+    // Начать замер стадии
+    void startStage(const std::string& name);
+
+    // Закончить текущую стадию
+    void finishStage(uint64_t bytes, uint64_t words, uint64_t distinctWords, uint64_t tableBytes);
+
+    const std::vector<Stage>& getStages() const { return stages; }
+
+    // Вывести таблицу для человека
+    void writeText(std::ostream& out) const;
+
+    // Вывести JSON
+    void writeJson(std::ostream& out) const;
+};
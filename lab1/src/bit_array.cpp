@@ -1,6 +1,12 @@
 #include "bit_array.h"
 #include <stdexcept>
 #include <algorithm>
+#include <bitset>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define BIT_ARRAY_AVX2_COUNT
+#endif
 
 constexpr size_t BITS_PER_LONG = sizeof(unsigned long) * 8;
 
@@ -8,17 +14,95 @@ size_t num_longs(size_t num_bits) {
     return (num_bits + BITS_PER_LONG - 1) / BITS_PER_LONG;
 }
 
-BitArray::BitArray() : data_(nullptr), size_(0), capacity_(0) {}
+//Количество единичных бит в одном слове.
+inline size_t popcount_word(unsigned long val) {
+#if defined(__GNUC__)
+    return __builtin_popcountl(val);
+#else
+    return std::bitset<BITS_PER_LONG>(val).count();
+#endif
+}
+
+//Индекс младшего единичного бита, val != 0.
+inline size_t lowest_bit(unsigned long val) {
+#if defined(__GNUC__)
+    return __builtin_ctzl(val);
+#else
+    size_t index = 0;
+    while ((val & 1UL) == 0) {
+        val >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+size_t popcount_words(const unsigned long* data, size_t num_elements) {
+    size_t counter = 0;
+    for (size_t i = 0; i < num_elements; ++i) {
+        counter += popcount_word(data[i]);
+    }
+    return counter;
+}
+
+#ifdef BIT_ARRAY_AVX2_COUNT
+//Начиная с этого числа слов count() переходит на AVX2, если процессор его поддерживает.
+constexpr size_t AVX2_COUNT_MIN_LONGS = 64;
+
+//Подсчет по 32 байта за шаг: каждый полубайт переводится в число единиц
+//через таблицу (vpshufb), суммы по байтам копятся не более 31 шага,
+//чтобы не переполнить байтовый счетчик, и затем сворачиваются в 64 бита (vpsadbw).
+__attribute__((target("avx2")))
+size_t popcount_words_avx2(const unsigned long* data, size_t num_elements) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    size_t full_bytes = num_elements * sizeof(unsigned long) / 32 * 32;
+
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = zero;
+
+    size_t i = 0;
+    while (i < full_bytes) {
+        size_t block_end = std::min(full_bytes, i + 31 * 32);
+        __m256i acc = zero;
+        for (; i < block_end; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+            __m256i lo = _mm256_and_si256(v, low_mask);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+            acc = _mm256_add_epi8(acc, _mm256_shuffle_epi8(lookup, lo));
+            acc = _mm256_add_epi8(acc, _mm256_shuffle_epi8(lookup, hi));
+        }
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(acc, zero));
+    }
+
+    size_t counter = static_cast<size_t>(_mm256_extract_epi64(total, 0)) +
+                     static_cast<size_t>(_mm256_extract_epi64(total, 1)) +
+                     static_cast<size_t>(_mm256_extract_epi64(total, 2)) +
+                     static_cast<size_t>(_mm256_extract_epi64(total, 3));
+
+    size_t done = full_bytes / sizeof(unsigned long);
+    return counter + popcount_words(data + done, num_elements - done);
+}
+#endif
+
+constexpr size_t INLINE_BITS = BitArray::INLINE_LONGS * BITS_PER_LONG;
+
+BitArray::BitArray() : data_(inline_), size_(0), capacity_(INLINE_BITS), inline_{} {}
 
 BitArray::~BitArray() {
-    delete[] data_;
+    release();
 }
 
 BitArray::BitArray(int num_bits, unsigned long value)
-    : data_(nullptr), size_(num_bits), capacity_(num_bits) {
+    : data_(inline_), size_(num_bits), capacity_(INLINE_BITS), inline_{} {
     if (num_bits > 0) {
         size_t num_elements = num_longs(num_bits);
-        data_ = new unsigned long[num_elements]();
+        if (num_elements > INLINE_LONGS) {
+            data_ = new unsigned long[num_elements]();
+            capacity_ = num_elements * BITS_PER_LONG;
+        }
         if (value != 0) {
             data_[0] = value;
             // Обнуляем биты, выходящие за пределы size_
@@ -31,18 +115,31 @@ BitArray::BitArray(int num_bits, unsigned long value)
 }
 
 BitArray::BitArray(const BitArray& b)
-    : data_(nullptr), size_(b.size_), capacity_(b.capacity_) {
-    if (capacity_ > 0) {
-        size_t num_elements = num_longs(capacity_);
+    : data_(inline_), size_(b.size_), capacity_(INLINE_BITS), inline_{} {
+    size_t num_elements = num_longs(size_);
+    if (num_elements > INLINE_LONGS) {
         data_ = new unsigned long[num_elements];
-        std::copy(b.data_, b.data_ + num_elements, data_);
+        capacity_ = num_elements * BITS_PER_LONG;
     }
+    std::copy(b.data_, b.data_ + num_elements, data_);
+}
+
+BitArray::BitArray(BitArray&& b) noexcept
+    : data_(inline_), size_(0), capacity_(INLINE_BITS), inline_{} {
+    take(b);
 }
 
 void BitArray::swap(BitArray& b) noexcept {
-    std::swap(data_, b.data_);
-    std::swap(size_, b.size_);
-    std::swap(capacity_, b.capacity_);
+    if (!is_inline() && !b.is_inline()) {
+        std::swap(data_, b.data_);
+        std::swap(size_, b.size_);
+        std::swap(capacity_, b.capacity_);
+        return;
+    }
+
+    BitArray temp(std::move(b));
+    b = std::move(*this);
+    *this = std::move(temp);
 }
 
 BitArray& BitArray::operator=(const BitArray& b) {
@@ -53,60 +150,193 @@ BitArray& BitArray::operator=(const BitArray& b) {
     return *this;
 }
 
-void BitArray::resize(size_t num_bits, bool value) {
-    size_t old_size = size_;
-    size_t new_capacity = num_bits;
+BitArray& BitArray::operator=(BitArray&& b) noexcept {
+    if (this != &b) {
+        release();
+        take(b);
+    }
+    return *this;
+}
 
-    if (new_capacity > capacity_) {
-        size_t num_elements = num_longs(new_capacity);
-        unsigned long* new_data = new unsigned long[num_elements]();
+bool BitArray::is_inline() const {
+    return data_ == inline_;
+}
 
-        if (data_) {
-            size_t old_num_elements = num_longs(capacity_);
-            std::copy(data_, data_ + old_num_elements, new_data);
-            delete[] data_;
-        }
+void BitArray::release() noexcept {
+    if (!is_inline()) {
+        delete[] data_;
+    }
+    data_ = inline_;
+    size_ = 0;
+    capacity_ = INLINE_BITS;
+    std::fill(inline_, inline_ + INLINE_LONGS, 0UL);
+}
 
-        data_ = new_data;
-        capacity_ = new_capacity;
+void BitArray::take(BitArray& b) noexcept {
+    //Внешний буфер забирается целиком, встроенный копируется.
+    if (b.is_inline()) {
+        std::copy(b.inline_, b.inline_ + INLINE_LONGS, inline_);
+        data_ = inline_;
+    } else {
+        data_ = b.data_;
+        b.data_ = b.inline_;
     }
+    size_ = b.size_;
+    capacity_ = b.capacity_;
 
+    b.size_ = 0;
+    b.capacity_ = INLINE_BITS;
+    std::fill(b.inline_, b.inline_ + INLINE_LONGS, 0UL);
+}
+
+void BitArray::resize(size_t num_bits, bool value) {
+    size_t old_size = size_;
+    grow(num_bits);
     size_ = num_bits;
 
     if (num_bits > old_size) {
-        for (size_t i = old_size; i < num_bits; ++i) {
-            this->set(i, value);
-        }
+        fill_bits(old_size, num_bits, value);
+    } else {
+        //Биты за size_ должны быть нулями: их читают count, any и append_word.
+        std::fill(data_ + num_longs(num_bits), data_ + num_longs(old_size), 0UL);
+        clear_tail();
+    }
+}
+
+void BitArray::reserve(size_t num_bits) {
+    if (num_bits > capacity_) {
+        reallocate(num_bits);
+    }
+}
+
+size_t BitArray::capacity() const {
+    return capacity_;
+}
+
+void BitArray::shrink_to_fit() {
+    if (!is_inline() && num_longs(size_) < num_longs(capacity_)) {
+        reallocate(size_);
     }
 }
 
 void BitArray::clear() {
-    delete[] data_;
-    data_ = nullptr;
-    size_ = 0;
-    capacity_ = 0;
+    release();
 }
 
 void BitArray::push_back(bool bit) {
-    if (size_ >= capacity_) {
-        size_t new_capacity = capacity_ == 0 ? BITS_PER_LONG : capacity_ * 2;
-        resize(size_, false);
-        capacity_ = new_capacity;
-
-        size_t num_elements = num_longs(capacity_);
-        unsigned long* new_data = new unsigned long[num_elements]();
-
-        if (data_) {
-            size_t old_num_elements = num_longs(size_);
-            std::copy(data_, data_ + old_num_elements, new_data);
-            delete[] data_;
+    grow(size_ + 1);
+    size_++;
+    set(size_ - 1, bit);
+}
+
+void BitArray::append(const BitArray& b) {
+    if (this == &b) {
+        BitArray copy(b);
+        append(copy);
+        return;
+    }
+
+    grow(size_ + b.size_);
+    size_t full_blocks = b.size_ / BITS_PER_LONG;
+    for (size_t i = 0; i < full_blocks; ++i) {
+        append_word(b.data_[i], BITS_PER_LONG);
+    }
+    if (b.size_ % BITS_PER_LONG != 0) {
+        append_word(b.data_[full_blocks], b.size_ % BITS_PER_LONG);
+    }
+}
+
+void BitArray::append_bits(uint64_t word, int nbits) {
+    if (nbits < 0 || nbits > 64) {
+        throw std::invalid_argument("Number of bits must be in [0, 64]");
+    }
+
+    grow(size_ + nbits);
+    for (size_t shift = 0; shift < static_cast<size_t>(nbits); shift += BITS_PER_LONG) {
+        size_t chunk = std::min(BITS_PER_LONG, nbits - shift);
+        append_word(static_cast<unsigned long>(word >> shift), chunk);
+    }
+}
+
+void BitArray::grow(size_t num_bits) {
+    //Емкость растет не меньше чем вдвое, чтобы добавление было амортизированно O(1).
+    if (num_bits > capacity_) {
+        reallocate(std::max(num_bits, capacity_ * 2));
+    }
+}
+
+void BitArray::reallocate(size_t new_capacity) {
+    size_t num_elements = num_longs(size_);
+
+    if (new_capacity <= INLINE_BITS) {
+        if (!is_inline()) {
+            unsigned long* old_data = data_;
+            std::fill(inline_, inline_ + INLINE_LONGS, 0UL);
+            std::copy(old_data, old_data + num_elements, inline_);
+            delete[] old_data;
+            data_ = inline_;
+            capacity_ = INLINE_BITS;
         }
+        return;
+    }
 
-        data_ = new_data;
+    size_t new_num_elements = num_longs(new_capacity);
+    unsigned long* new_data = new unsigned long[new_num_elements]();
+    std::copy(data_, data_ + num_elements, new_data);
+    if (!is_inline()) {
+        delete[] data_;
     }
 
-    size_++;
-    set(size_ - 1, bit);
+    data_ = new_data;
+    capacity_ = new_num_elements * BITS_PER_LONG;
+}
+
+void BitArray::fill_bits(size_t from, size_t to, bool value) {
+    if (from >= to) {
+        return;
+    }
+
+    size_t first = from / BITS_PER_LONG;
+    size_t last = (to - 1) / BITS_PER_LONG;
+    unsigned long head_mask = ~0UL << (from % BITS_PER_LONG);
+    unsigned long tail_mask = ~0UL >> (BITS_PER_LONG - 1 - (to - 1) % BITS_PER_LONG);
+
+    auto apply = [this, value](size_t index, unsigned long mask) {
+        if (value) {
+            data_[index] |= mask;
+        } else {
+            data_[index] &= ~mask;
+        }
+    };
+
+    if (first == last) {
+        apply(first, head_mask & tail_mask);
+        return;
+    }
+
+    apply(first, head_mask);
+    std::fill(data_ + first + 1, data_ + last, value ? ~0UL : 0UL);
+    apply(last, tail_mask);
+}
+
+void BitArray::append_word(unsigned long word, size_t nbits) {
+    if (nbits < BITS_PER_LONG) {
+        word &= (1UL << nbits) - 1;
+    }
+
+    //Биты за size_ в текущем слове нулевые, поэтому новое слово
+    //достаточно наложить со сдвигом, а остаток записать в следующее.
+    size_t index = size_ / BITS_PER_LONG;
+    size_t offset = size_ % BITS_PER_LONG;
+    if (offset == 0) {
+        data_[index] = word;
+    } else {
+        data_[index] |= word << offset;
+        if (offset + nbits > BITS_PER_LONG) {
+            data_[index + 1] = word >> (BITS_PER_LONG - offset);
+        }
+    }
+    size_ += nbits;
 }
 
 BitArray& BitArray::operator&=(const BitArray& b) {
@@ -152,12 +382,26 @@ BitArray& BitArray::operator<<=(int n) {
         return *this;
     }
 
-    for (int i = size_ - 1; i >= n; --i) {
-        set(i, (*this)[i - n]);
-    }
-    for (int i = 0; i < n; ++i) {
-        reset(i);
+    //Сдвиг раскладывается на сдвиг на целые слова и перенос
+    //bit_shift старших бит каждого слова в младшие биты следующего.
+    size_t num_elements = num_longs(size_);
+    size_t word_shift = n / BITS_PER_LONG;
+    size_t bit_shift = n % BITS_PER_LONG;
+
+    if (bit_shift == 0) {
+        for (size_t i = num_elements; i-- > word_shift;) {
+            data_[i] = data_[i - word_shift];
+        }
+    } else {
+        for (size_t i = num_elements; i-- > word_shift + 1;) {
+            data_[i] = (data_[i - word_shift] << bit_shift) |
+                       (data_[i - word_shift - 1] >> (BITS_PER_LONG - bit_shift));
+        }
+        data_[word_shift] = data_[0] << bit_shift;
     }
+    std::fill(data_, data_ + word_shift, 0UL);
+
+    clear_tail();
     return *this;
 }
 
@@ -168,12 +412,27 @@ BitArray& BitArray::operator>>=(int n) {
         return *this;
     }
 
-    for (size_t i = 0; i < size_ - n; ++i) {
-        set(i, (*this)[i + n]);
-    }
-    for (size_t i = size_ - n; i < size_; ++i) {
-        reset(i);
+    //Биты за пределами size_ не должны попасть внутрь массива.
+    clear_tail();
+
+    size_t num_elements = num_longs(size_);
+    size_t word_shift = n / BITS_PER_LONG;
+    size_t bit_shift = n % BITS_PER_LONG;
+    size_t last = num_elements - word_shift - 1;
+
+    if (bit_shift == 0) {
+        for (size_t i = 0; i <= last; ++i) {
+            data_[i] = data_[i + word_shift];
+        }
+    } else {
+        for (size_t i = 0; i < last; ++i) {
+            data_[i] = (data_[i + word_shift] >> bit_shift) |
+                       (data_[i + word_shift + 1] << (BITS_PER_LONG - bit_shift));
+        }
+        data_[last] = data_[num_elements - 1] >> bit_shift;
     }
+    std::fill(data_ + last + 1, data_ + num_elements, 0UL);
+
     return *this;
 }
 
@@ -211,11 +470,7 @@ BitArray& BitArray::set() {
         data_[i] = ~0UL;
     }
 
-    if (size_ % BITS_PER_LONG != 0) {
-        size_t last_bits = size_ % BITS_PER_LONG;
-        unsigned long mask = (1UL << last_bits) - 1;
-        data_[num_elements - 1] &= mask;
-    }
+    clear_tail();
     return *this;
 }
 
@@ -246,7 +501,7 @@ bool BitArray::none() const {
 }
 
 BitArray BitArray::operator~() const {
-    if (data_ == nullptr) {
+    if (size_ == 0) {
         return {};
     }
 
@@ -256,26 +511,28 @@ BitArray BitArray::operator~() const {
         result.data_[i] = ~result.data_[i];
     }
 
+    result.clear_tail();
+
+    return result;
+}
+
+void BitArray::clear_tail() {
     if (size_ % BITS_PER_LONG != 0) {
         size_t last_bits = size_ % BITS_PER_LONG;
         unsigned long mask = (1UL << last_bits) - 1;
-        result.data_[num_elements - 1] &= mask;
+        data_[num_longs(size_) - 1] &= mask;
     }
-
-    return result;
 }
 
 int BitArray::count() const {
-    int counter = 0;
     size_t num_elements = num_longs(size_);
-    for (size_t i = 0; i < num_elements; ++i) {
-        unsigned long val = data_[i];
-        while (val) {
-            counter += val & 1;
-            val >>= 1;
-        }
+#ifdef BIT_ARRAY_AVX2_COUNT
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2 && num_elements >= AVX2_COUNT_MIN_LONGS) {
+        return static_cast<int>(popcount_words_avx2(data_, num_elements));
     }
-    return counter;
+#endif
+    return static_cast<int>(popcount_words(data_, num_elements));
 }
 
 bool BitArray::operator[](int i) const {
@@ -329,13 +586,43 @@ std::string BitArray::to_string() const {
     return result;
 }
 
-bool operator==(const BitArray& a, const BitArray& b) {
-    if (a.size() != b.size()) return false;
+int BitArray::find_first_difference(const BitArray& b) const {
+    size_t common = std::min(size_, b.size_);
+    size_t full_blocks = common / BITS_PER_LONG;
+
+    for (size_t i = 0; i < full_blocks; ++i) {
+        unsigned long diff = data_[i] ^ b.data_[i];
+        if (diff != 0) {
+            return static_cast<int>(i * BITS_PER_LONG + lowest_bit(diff));
+        }
+    }
+
+    //Хвостовое слово сравнивается только в пределах общей длины.
+    size_t remaining_bits = common % BITS_PER_LONG;
+    if (remaining_bits > 0) {
+        unsigned long mask = (1UL << remaining_bits) - 1;
+        unsigned long diff = (data_[full_blocks] ^ b.data_[full_blocks]) & mask;
+        if (diff != 0) {
+            return static_cast<int>(full_blocks * BITS_PER_LONG + lowest_bit(diff));
+        }
+    }
+
+    return size_ == b.size_ ? -1 : static_cast<int>(common);
+}
 
-    for (int i = 0; i < a.size(); ++i) {
-        if (a[i] != b[i]) return false;
+int BitArray::compare(const BitArray& b) const {
+    int index = find_first_difference(b);
+    if (index < 0) {
+        return 0;
     }
-    return true;
+    if (index == static_cast<int>(std::min(size_, b.size_))) {
+        return size_ < b.size_ ? -1 : 1;
+    }
+    return (*this)[index] ? 1 : -1;
+}
+
+bool operator==(const BitArray& a, const BitArray& b) {
+    return a.size() == b.size() && a.find_first_difference(b) < 0;
 }
 
 bool operator!=(const BitArray& a, const BitArray& b) {
@@ -6,6 +6,10 @@
 class BitArray
 {
 public:
+  //Число слов встроенного буфера: массивы до INLINE_LONGS * sizeof(long) * 8 бит
+  //хранятся внутри объекта и не выделяют память в куче.
+  static constexpr size_t INLINE_LONGS = 4;
+
   BitArray();
   ~BitArray();
   
@@ -13,21 +17,35 @@ public:
   //Первые sizeof(long) бит можно инициализровать с помощью параметра value.
   explicit BitArray(int num_bits, unsigned long value = 0);
   BitArray(const BitArray& b);
+  //Забирает содержимое b, оставляя его пустым.
+  BitArray(BitArray&& b) noexcept;
 
 
   //Обменивает значения двух битовых массивов.
   void swap(BitArray& b) noexcept;
 
   BitArray& operator=(const BitArray& b);
+  BitArray& operator=(BitArray&& b) noexcept;
   
   //Изменяет размер массива. В случае расширения, новые элементы 
   //инициализируются значением value.
   void resize(size_t num_bits, bool value = false);
+  //Гарантирует емкость не меньше num_bits бит без изменения размера.
+  void reserve(size_t num_bits);
+  //Количество бит, которое массив вмещает без перераспределения памяти.
+  [[nodiscard]] size_t capacity() const;
+  //Уменьшает емкость до размера массива.
+  void shrink_to_fit();
   //Очищает массив.
   void clear();
   //Добавляет новый бит в конец массива. В случае необходимости 
   //происходит перераспределение памяти.
   void push_back(bool bit);
+  //Добавляет в конец все биты массива b.
+  void append(const BitArray& b);
+  //Добавляет в конец младшие nbits бит числа word, начиная с нулевого.
+  //nbits должно лежать в [0, 64].
+  void append_bits(uint64_t word, int nbits);
 
 
   //Битовые операции над массивами.
@@ -70,12 +88,39 @@ public:
   [[nodiscard]] int size() const;
   [[nodiscard]] bool empty() const;
   
+  //Возвращает индекс первого (начиная с бита 0) бита, в котором массивы различаются,
+  //или -1, если массивы равны. Если один массив является началом другого,
+  //возвращает длину более короткого.
+  [[nodiscard]] int find_first_difference(const BitArray& b) const;
+  //Лексикографическое сравнение по индексам от 0 к size() - 1: решает первый
+  //различающийся бит (массив с 0 в нем меньше), а начало массива меньше
+  //самого массива. Возвращает отрицательное число, 0 или положительное число.
+  [[nodiscard]] int compare(const BitArray& b) const;
+
   //Возвращает строковое представление массива.
   [[nodiscard]] std::string to_string() const;
 private:
-  unsigned long* data_;
+  //Обнуляет биты последнего слова, выходящие за пределы size_.
+  void clear_tail();
+  //Увеличивает емкость хотя бы до num_bits с геометрическим ростом.
+  void grow(size_t num_bits);
+  //Переносит данные в буфер емкостью new_capacity бит.
+  void reallocate(size_t new_capacity);
+  //Присваивает value битам с индексами [from, to).
+  void fill_bits(size_t from, size_t to, bool value);
+  //Дописывает nbits младших бит word в конец; память должна быть выделена.
+  void append_word(unsigned long word, size_t nbits);
+  //true, если данные лежат во встроенном буфере.
+  [[nodiscard]] bool is_inline() const;
+  //Освобождает внешний буфер и делает массив пустым.
+  void release() noexcept;
+  //Переносит содержимое b в пустой массив, оставляя b пустым.
+  void take(BitArray& b) noexcept;
+
+  unsigned long* data_;   // inline_ или буфер в куче
   size_t size_;       // in bits
   size_t capacity_;   // in bits
+  unsigned long inline_[INLINE_LONGS];
 };
 
 bool operator==(const BitArray & a, const BitArray & b);
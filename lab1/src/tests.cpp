@@ -1,6 +1,8 @@
 #include "tests.h"
 #include "bit_array.h"
 #include "test_runner.h"
+#include <stdexcept>
+#include <utility>
 
 void TestConstructor() {
     /*    проверяет конструктор по умолчанию,
@@ -74,6 +76,63 @@ void TestAssignment() {
     ASSERT_EQUAL(a.size(), 2);
 }
 
+void TestMove() {
+    /*  проверяет перемещение и обмен для массивов
+     *  во встроенном буфере и в куче
+     */
+    const int small_size = 100;
+    const int large_size = BitArray::INLINE_LONGS * sizeof(unsigned long) * 8 + 50;
+
+    BitArray small(small_size, 0b1011);
+    BitArray large(large_size, 0b110);
+    large.set(large_size - 1);
+    std::string small_str = small.to_string();
+    std::string large_str = large.to_string();
+
+    // Конструктор перемещения
+    BitArray moved_small(std::move(small));
+    BitArray moved_large(std::move(large));
+    ASSERT_EQUAL(moved_small.to_string(), small_str);
+    ASSERT_EQUAL(moved_large.to_string(), large_str);
+    ASSERT_EQUAL(small.empty(), true);
+    ASSERT_EQUAL(large.empty(), true);
+
+    // Перемещенный массив можно использовать дальше
+    small.push_back(true);
+    ASSERT_EQUAL(small.to_string(), "1");
+    large.resize(large_size, true);
+    ASSERT_EQUAL(large.count(), large_size);
+
+    // Присваивание перемещением в обе стороны
+    BitArray target(large_size, 1);
+    target = std::move(moved_small);
+    ASSERT_EQUAL(target.to_string(), small_str);
+    target = std::move(moved_large);
+    ASSERT_EQUAL(target.to_string(), large_str);
+    ASSERT_EQUAL(moved_small.size(), 0);
+    ASSERT_EQUAL(moved_large.size(), 0);
+
+    // Обмен массивов с разными видами хранения
+    BitArray a(small_size, 0b1011);
+    BitArray b(target);
+    a.swap(b);
+    ASSERT_EQUAL(a.to_string(), large_str);
+    ASSERT_EQUAL(b.to_string(), small_str);
+    b.swap(a);
+    ASSERT_EQUAL(a.to_string(), small_str);
+    ASSERT_EQUAL(b.to_string(), large_str);
+
+    BitArray c(3, 0b101);
+    a.swap(c);
+    ASSERT_EQUAL(a.to_string(), "101");
+    ASSERT_EQUAL(c.to_string(), small_str);
+
+    // Результат операторов не теряется при перемещении
+    BitArray shifted = b << 1;
+    ASSERT_EQUAL(shifted[large_size - 1], false);
+    ASSERT_EQUAL(shifted[3], true);
+}
+
 void TestSizeEditing() {
     /*  проверяет методы:
      *      resize,
@@ -116,6 +175,145 @@ void TestSizeEditing() {
     }
 }
 
+void TestCapacity() {
+    /*  проверяет методы:
+     *      reserve,
+     *      capacity,
+     *      shrink_to_fit
+     *  и геометрический рост емкости
+     */
+    BitArray arr;
+    size_t initial = arr.capacity();
+    ASSERT(initial > 0);
+
+    arr.reserve(10000);
+    ASSERT(arr.capacity() >= 10000u);
+    ASSERT_EQUAL(arr.size(), 0);
+
+    // Внутри зарезервированной емкости память не перераспределяется
+    size_t reserved = arr.capacity();
+    for (int i = 0; i < 10000; ++i) {
+        arr.push_back(i % 3 == 0);
+    }
+    ASSERT_EQUAL(arr.capacity(), reserved);
+
+    // При последовательном добавлении емкость меняется логарифмическое число раз
+    BitArray grown;
+    int reallocations = 0;
+    size_t last_capacity = grown.capacity();
+    for (int i = 0; i < 100000; ++i) {
+        grown.push_back(true);
+        if (grown.capacity() != last_capacity) {
+            ++reallocations;
+            last_capacity = grown.capacity();
+        }
+    }
+    ASSERT(reallocations < 20);
+    ASSERT_EQUAL(grown.count(), 100000);
+
+    // Уменьшение емкости сохраняет содержимое
+    std::string before = arr.to_string();
+    arr.resize(300);
+    arr.shrink_to_fit();
+    ASSERT(arr.capacity() >= 300u);
+    ASSERT(arr.capacity() < reserved);
+    ASSERT_EQUAL(arr.to_string(), before.substr(before.size() - 300));
+
+    // Маленький массив возвращается во встроенный буфер
+    arr.resize(5);
+    arr.shrink_to_fit();
+    ASSERT_EQUAL(arr.capacity(), initial);
+    ASSERT_EQUAL(arr.to_string(), before.substr(before.size() - 5));
+
+    // Расширение после уменьшения заполняет новые биты заданным значением
+    BitArray ones(200, 0);
+    ones.set();
+    ones.resize(70);
+    ones.resize(200, false);
+    ASSERT_EQUAL(ones.count(), 70);
+    ones.resize(1000, true);
+    ASSERT_EQUAL(ones.count(), 70 + 800);
+
+    // После уменьшения освободившиеся слова обнулены и не возвращаются при росте
+    BitArray shrunk(200);
+    shrunk.set();
+    shrunk.resize(10);
+    for (int i = 0; i < 55; ++i) {
+        shrunk.push_back(false);
+    }
+    ASSERT_EQUAL(shrunk.count(), 10);
+    for (int i = 0; i < 10; ++i) {
+        shrunk.reset(i);
+    }
+    ASSERT(!shrunk.any());
+    ASSERT(shrunk.none());
+    shrunk.append_bits(0, 64);
+    ASSERT_EQUAL(shrunk.count(), 0);
+}
+
+void TestAppend() {
+    /*  проверяет методы:
+     *      append,
+     *      append_bits
+     *  сравнением с поочередным push_back
+     */
+    unsigned long seed = 4242;
+    auto random_array = [&seed](int size) {
+        BitArray arr(size);
+        for (int i = 0; i < size; ++i) {
+            seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+            arr.set(i, (seed >> 37) & 1);
+        }
+        return arr;
+    };
+
+    const int sizes[] = {0, 1, 7, 63, 64, 65, 130, 500};
+    for (int head_size : sizes) {
+        for (int tail_size : sizes) {
+            BitArray head = random_array(head_size);
+            BitArray tail = random_array(tail_size);
+
+            BitArray expected(head);
+            for (int i = 0; i < tail_size; ++i) {
+                expected.push_back(tail[i]);
+            }
+
+            BitArray result(head);
+            result.append(tail);
+            ASSERT_EQUAL(result == expected, true);
+            ASSERT_EQUAL(result.count(), expected.count());
+        }
+    }
+
+    // Добавление самого себя
+    BitArray self = random_array(100);
+    std::string self_str = self.to_string();
+    self.append(self);
+    ASSERT_EQUAL(self.to_string(), self_str + self_str);
+
+    // append_bits
+    BitArray bits;
+    bits.append_bits(0b1011, 4);
+    ASSERT_EQUAL(bits.to_string(), "1011");
+    bits.append_bits(0xFFFFFFFFFFFFFFFFULL, 0);
+    ASSERT_EQUAL(bits.size(), 4);
+    bits.append_bits(0x8000000000000001ULL, 64);
+    ASSERT_EQUAL(bits.size(), 68);
+    ASSERT_EQUAL(bits.count(), 5);
+    ASSERT_EQUAL(bits[4], true);
+    ASSERT_EQUAL(bits[67], true);
+    bits.append_bits(0b110, 2);
+    ASSERT_EQUAL(bits.to_string().substr(0, 3), "101");
+
+    bool thrown = false;
+    try {
+        bits.append_bits(1, 65);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    ASSERT(thrown);
+}
+
 void TestBitwiseOperation() {
     /*  проверяет битовые операции:
      *      побитовый & (and),
@@ -224,6 +422,41 @@ void TestBitShift() {
     }
 }
 
+void TestBitShiftWords() {
+    /*  сравнивает пословные сдвиги с побитовым эталоном
+     *  на размерах и сдвигах около границ слов
+     */
+    const int bits = sizeof(unsigned long) * 8;
+    const int sizes[] = {1, 5, bits - 1, bits, bits + 1, 2 * bits, 2 * bits + 3, 1000};
+    unsigned long seed = 12345;
+
+    for (int size : sizes) {
+        BitArray arr(size);
+        for (int i = 0; i < size; ++i) {
+            seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+            arr.set(i, (seed >> 33) & 1);
+        }
+
+        const int shifts[] = {0, 1, 3, bits - 1, bits, bits + 1, 2 * bits + 7, size - 1, size, size + 5};
+        for (int n : shifts) {
+            BitArray left = arr << n;
+            BitArray right = arr >> n;
+            int left_count = 0, right_count = 0;
+            for (int i = 0; i < size; ++i) {
+                bool expected_left = i >= n ? arr[i - n] : false;
+                bool expected_right = i + n < size ? arr[i + n] : false;
+                ASSERT_EQUAL(left[i], expected_left);
+                ASSERT_EQUAL(right[i], expected_right);
+                left_count += expected_left;
+                right_count += expected_right;
+            }
+            // За пределы size_ ничего не выдвинуто
+            ASSERT_EQUAL(left.count(), left_count);
+            ASSERT_EQUAL(right.count(), right_count);
+        }
+    }
+}
+
 void TestSetAndReset() {
     /*  проверяет методы:
      *      set,
@@ -318,6 +551,30 @@ void TestCount() {
     ASSERT_EQUAL(mixed.count(), 3);
 }
 
+void TestCountLarge() {
+    // проверяет count на массивах, которые считаются пословно и векторно
+    const int sizes[] = {63, 64, 65, 64 * 64 - 1, 64 * 64 + 100, 100003};
+    unsigned long seed = 777;
+
+    for (int size : sizes) {
+        BitArray arr(size);
+        int expected = 0;
+        for (int i = 0; i < size; ++i) {
+            seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+            bool bit = (seed >> 40) % 3 == 0;
+            arr.set(i, bit);
+            expected += bit;
+        }
+        ASSERT_EQUAL(arr.count(), expected);
+
+        arr.set();
+        ASSERT_EQUAL(arr.count(), size);
+
+        arr.reset();
+        ASSERT_EQUAL(arr.count(), 0);
+    }
+}
+
 void TestGet() {
     // проверяет получение i-ого бита
     BitArray arr(5, 0b10101);
@@ -386,6 +643,49 @@ void TestComparison() {
     ASSERT_EQUAL(f == c, false);
 }
 
+void TestFindFirstDifference() {
+    /* проверяет методы:
+     *      find_first_difference,
+     *      compare
+     */
+    BitArray empty1, empty2;
+    ASSERT_EQUAL(empty1.find_first_difference(empty2), -1);
+    ASSERT_EQUAL(empty1.compare(empty2), 0);
+
+    // различие в каждом бите длинного массива, в том числе на границах слов
+    BitArray a(300);
+    for (int i = 0; i < 300; i += 7) {
+        a.set(i);
+    }
+    BitArray same(a);
+    ASSERT_EQUAL(a.find_first_difference(same), -1);
+    ASSERT_EQUAL(a.compare(same), 0);
+    for (int i = 0; i < 300; ++i) {
+        BitArray b(a);
+        b.set(i, !a[i]);
+        ASSERT_EQUAL(a.find_first_difference(b), i);
+        ASSERT_EQUAL(b.find_first_difference(a), i);
+        ASSERT_EQUAL(a.compare(b) < 0, !a[i]);
+        ASSERT_EQUAL(b.compare(a) < 0, a[i]);
+        ASSERT_EQUAL(a == b, false);
+    }
+
+    // начало массива меньше самого массива
+    BitArray prefix(a);
+    prefix.resize(130);
+    ASSERT_EQUAL(a.find_first_difference(prefix), 130);
+    ASSERT_EQUAL(prefix.compare(a) < 0, true);
+    ASSERT_EQUAL(a.compare(prefix) > 0, true);
+    ASSERT_EQUAL(prefix == a, false);
+
+    // биты за пределами размера не участвуют в сравнении
+    BitArray shrunk(8, 0xFF);
+    shrunk.resize(4);
+    BitArray ones(4, 0xF);
+    ASSERT_EQUAL(shrunk == ones, true);
+    ASSERT_EQUAL(shrunk.compare(ones), 0);
+}
+
 void TestToString() {
     // проверяет метод to_string
     // Пустой массив
@@ -412,15 +712,21 @@ void TestAll() {
     RUN_TEST(tr, TestConstructor);
     RUN_TEST(tr, TestSwap);
     RUN_TEST(tr, TestAssignment);
+    RUN_TEST(tr, TestMove);
     RUN_TEST(tr, TestSizeEditing);
+    RUN_TEST(tr, TestCapacity);
+    RUN_TEST(tr, TestAppend);
     RUN_TEST(tr, TestBitwiseOperation);
     RUN_TEST(tr, TestBitShift);
+    RUN_TEST(tr, TestBitShiftWords);
     RUN_TEST(tr, TestSetAndReset);
     RUN_TEST(tr, TestAny);
     RUN_TEST(tr, TestNone);
     RUN_TEST(tr, TestBitwiseInversion);
     RUN_TEST(tr, TestCount);
+    RUN_TEST(tr, TestCountLarge);
     RUN_TEST(tr, TestGet);
     RUN_TEST(tr, TestSizeChecking);
     RUN_TEST(tr, TestComparison);
+    RUN_TEST(tr, TestFindFirstDifference);
 }
@@ -3,17 +3,23 @@
 void TestConstructor();
 void TestSwap();
 void TestAssignment();
+void TestMove();
 void TestSizeEditing();
+void TestCapacity();
+void TestAppend();
 void TestBitwiseOperation();
 void TestBitShift();
+void TestBitShiftWords();
 void TestSetAndReset();
 void TestAny();
 void TestNone();
 void TestBitwiseInversion();
 void TestCount();
+void TestCountLarge();
 void TestGet();
 void TestSizeChecking();
 void TestComparison();
+void TestFindFirstDifference();
 void TestToString();
 
 void TestAll();
\ No newline at end of file